@@ -366,6 +366,11 @@ void ElasticRodMaterial::getStress(const Vector &stress, const Vector &strain, c
   stress = matmul(getMaterialStiff(ielem, ip), strain);
 }
 
+bool ElasticRodMaterial::isThreadSafe() const
+{
+  return true;
+}
+
 void ElasticRodMaterial::getTable(const String &name, XTable &, const IdxVector &, const Vector &) const
 {
   using jive::IdxVector;
@@ -83,6 +83,8 @@ public:
 
   virtual void getStress(const Vector &stress, const Vector &strain, const idx_t &ielem, const idx_t &ip, const bool inelastic = false) override;
 
+  virtual bool isThreadSafe() const override;
+
   virtual void getTable(const String &name, XTable &strain_table, const IdxVector &items, const Vector &weights) const override;
 
   virtual void applyDeform() override;
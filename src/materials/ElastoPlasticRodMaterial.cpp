@@ -268,6 +268,11 @@ void ElastoPlasticRodMaterial::getStress(const Vector &stress, const Vector &str
   currDeltaFlow_(ip, ielem) = deltaFlow;
 }
 
+bool ElastoPlasticRodMaterial::isThreadSafe() const
+{
+  return false;
+}
+
 void ElastoPlasticRodMaterial::applyDeform()
 {
   Vector oldElastStrain(currStrains_.size(0));
@@ -75,6 +75,10 @@ public:
   /// @see [Computational Inelasticity](https://doi.org/10.1007/b98904) Box 3.6
   virtual void getStress(const Vector &stress, const Vector &strain, const idx_t &ielem, const idx_t &ip, const bool inelastic = true) override;
 
+  /// @brief Not thread safe, the return mapping evaluates the shared yield
+  /// condition functions
+  virtual bool isThreadSafe() const override;
+
   virtual void applyDeform() override;
 
   virtual void rejectDeform() override;
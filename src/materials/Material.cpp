@@ -31,6 +31,11 @@ Material::~Material()
 {
 }
 
+bool Material::isThreadSafe() const
+{
+  return false;
+}
+
 String Material::getContext() const
 {
   return NamedObject::makeContext("material", myName_);
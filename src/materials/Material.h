@@ -232,6 +232,17 @@ public:
    */
   virtual double getHardeningPotential(const idx_t &ielem, const idx_t &ip) const = 0;
 
+  /**
+   * @brief Whether the element-specific getStress may run concurrently.
+   *
+   * Models only evaluate different elements in parallel if the material
+   * declares this. Materials with shared scratch state must return false.
+   *
+   * @returns true if concurrent calls for different elements are safe
+   * @note Default is false
+   */
+  virtual bool isThreadSafe() const;
+
   /**
    * @brief Get the context string for error reporting and debugging.
    *
@@ -20,8 +20,13 @@
 
 using jive_helpers::expVec;
 using jive_helpers::expVecP;
+using jive_helpers::load;
 using jive_helpers::logMat;
+using jive_helpers::mat3Mul;
+using jive_helpers::mat3TMul;
 using jive_helpers::skew;
+using jive_helpers::store;
+using jive_helpers::Vec3;
 
 using jem::ALL;
 using jem::newInstance;
@@ -117,24 +122,32 @@ void Line3D::getShapeGradients(const Matrix &g,
 void Line3D::getRotations(const Cubix &Ri,
                           const Cubix &Rn) const
 {
-  Matrix Lambda_r(globalRank(), globalRank());
+  Mat3 Lambda_r;
+  Mat3 ipExp;
+  Mat3 ipRot;
+  Vec3 ip_psi;
   Matrix node_psi(globalRank(), nodeCount());
-  Matrix ip_psi(globalRank(), ipointCount());
 
   // get the Rotaion matrices and the relative rotations between them
   getNodeRotVecs_(node_psi, Lambda_r, Rn);
 
   // get the _local_ rotations in the integration points
-  Matrix shapeFuncs = getShapeFunctions();
+  const Matrix shapeFuncs = getShapeFunctions();
 
-  // get the rotation vectors associated with the local rotations
-  ip_psi = matmul(node_psi, shapeFuncs);
-
-  // construct the local rotation matrices
   for (idx_t iIp = 0; iIp < ipointCount(); iIp++)
   {
-    expVec(Ri[iIp], ip_psi[iIp]);
-    Ri[iIp] = matmul(Lambda_r, Ri[iIp]);
+    // get the rotation vectors associated with the local rotations
+    for (idx_t i = 0; i < 3; i++)
+    {
+      ip_psi[i] = 0.;
+      for (idx_t iNode = 0; iNode < nodeCount(); iNode++)
+        ip_psi[i] += node_psi(i, iNode) * shapeFuncs(iNode, iIp);
+    }
+
+    // construct the local rotation matrices
+    expVec(ipExp, ip_psi);
+    mat3Mul(ipRot, Lambda_r, ipExp);
+    store(Ri[iIp], ipRot);
   }
 }
 
@@ -143,22 +156,44 @@ void Line3D::getXi(const Quadix &Xi,
                    const Matrix &u,
                    const Matrix &c) const
 {
-  JEM_ASSERT2(Xi.size(0) == 6 && Xi.size(1) == 6 && Xi.size(2) == nodeCount() && Xi.size(3) == ipointCount(), "Xi size does not match the expected size");
-  Matrix shapes = getShapeFunctions();
   Matrix grads(shapeFuncCount(), ipointCount());
   getShapeGradients(grads, w, c);
 
-  Matrix phiP = matmul(Matrix(c + u), grads);
+  getXi(Xi, grads, u, c);
+}
+
+void Line3D::getXi(const Quadix &Xi,
+                   const Matrix &grads,
+                   const Matrix &u,
+                   const Matrix &c) const
+{
+  JEM_ASSERT2(Xi.size(0) == 6 && Xi.size(1) == 6 && Xi.size(2) == nodeCount() && Xi.size(3) == ipointCount(), "Xi size does not match the expected size");
+  const Matrix shapes = getShapeFunctions();
+
+  Vec3 phiP;
+  Mat3 PhiP;
 
   Xi = 0.;
 
   for (idx_t ip = 0; ip < ipointCount(); ip++)
+  {
+    for (idx_t i = 0; i < 3; i++)
+    {
+      phiP[i] = 0.;
+      for (idx_t iNode = 0; iNode < nodeCount(); iNode++)
+        phiP[i] += (c(i, iNode) + u(i, iNode)) * grads(iNode, ip);
+    }
+    skew(PhiP, phiP);
+
     for (idx_t iNode = 0; iNode < nodeCount(); iNode++)
     {
       for (idx_t i = 0; i < 6; i++)
         Xi(i, i, iNode, ip) = grads(iNode, ip);
-      Xi(SliceFrom(3), SliceTo(3), iNode, ip) = -1. * shapes(iNode, ip) * skew(phiP[ip]);
+      for (idx_t j = 0; j < 3; j++)
+        for (idx_t i = 0; i < 3; i++)
+          Xi(i + 3, j, iNode, ip) = -1. * shapes(iNode, ip) * PhiP(i, j);
     }
+  }
 }
 
 void Line3D::getPsi(const Quadix &Psi,
@@ -189,14 +224,7 @@ void Line3D::getPi(const Cubix &Pi,
 {
   const Cubix Ri(globalRank(), globalRank(), ipointCount());
 
-  getRotations(Ri, Rn);
-
-  Pi = 0.;
-  for (idx_t ip = 0; ip < ipointCount(); ip++)
-  {
-    Pi[ip](SliceTo(3), SliceTo(3)) = Ri[ip];
-    Pi[ip](SliceFrom(3), SliceFrom(3)) = Ri[ip];
-  }
+  getPi(Pi, Ri, Rn);
 }
 
 void Line3D::getPi(const Cubix &Pi,
@@ -207,67 +235,105 @@ void Line3D::getPi(const Cubix &Pi,
 
   Pi = 0.;
   for (idx_t ip = 0; ip < ipointCount(); ip++)
-  {
-    Pi[ip](SliceTo(3), SliceTo(3)) = Ri[ip];
-    Pi[ip](SliceFrom(3), SliceFrom(3)) = Ri[ip];
-  }
+    for (idx_t j = 0; j < 3; j++)
+      for (idx_t i = 0; i < 3; i++)
+      {
+        Pi(i, j, ip) = Ri(i, j, ip);
+        Pi(i + 3, j + 3, ip) = Ri(i, j, ip);
+      }
 }
 
 void Line3D::getRotationGradients(const Cubix &LambdaP,
                                   const Vector &w,
                                   const Matrix &c,
                                   const Cubix &nodeLambda) const
+{
+  Matrix grads(shapeFuncCount(), ipointCount());
+  getShapeGradients(grads, w, c);
+
+  getRotationGradients(LambdaP, grads, nodeLambda);
+}
+
+void Line3D::getRotationGradients(const Cubix &LambdaP,
+                                  const Matrix &grads,
+                                  const Cubix &nodeLambda) const
 {
   JEM_ASSERT2(LambdaP.size(0) == globalRank() && LambdaP.size(1) == globalRank() && LambdaP.size(2) == ipointCount(), "LambdaP size does not match the expected size");
 
-  Matrix Lambda_r(globalRank(), globalRank());
+  Mat3 Lambda_r;
+  Mat3 ipExpP;
+  Mat3 ipLambdaP;
+  Vec3 psi;
+  Vec3 psiP;
   Matrix node_psi(globalRank(), nodeCount());
-  Matrix ip_psi(globalRank(), ipointCount());
 
   // get the Rotaion matrices and the relative rotations between them
   getNodeRotVecs_(node_psi, Lambda_r, nodeLambda);
 
-  Matrix shapes = getShapeFunctions();
-  Matrix grads(shapeFuncCount(), ipointCount());
-  getShapeGradients(grads, w, c);
-
-  Matrix psi(globalRank(), ipointCount());
-  Matrix psiP(globalRank(), ipointCount());
-  psi = matmul(node_psi, shapes);
-  psiP = matmul(node_psi, grads);
+  const Matrix shapes = getShapeFunctions();
 
   for (idx_t ip = 0; ip < ipointCount(); ip++)
   {
-    expVecP(LambdaP[ip], psi[ip], psiP[ip]);
-    LambdaP[ip] = matmul(Lambda_r, LambdaP[ip]);
+    for (idx_t i = 0; i < 3; i++)
+    {
+      psi[i] = 0.;
+      psiP[i] = 0.;
+      for (idx_t iNode = 0; iNode < nodeCount(); iNode++)
+      {
+        psi[i] += node_psi(i, iNode) * shapes(iNode, ip);
+        psiP[i] += node_psi(i, iNode) * grads(iNode, ip);
+      }
+    }
+
+    expVecP(ipExpP, psi, psiP);
+    mat3Mul(ipLambdaP, Lambda_r, ipExpP);
+    store(LambdaP[ip], ipLambdaP);
   }
 }
 
 //------------------------------------------------------
 // private helper functions
 //------------------------------------------------------
-void Line3D::getRefRot_(const Matrix Lambda_r,
-                        const Cubix Rn) const
+void Line3D::getRefRot_(Mat3 &Lambda_r,
+                        const Cubix &Rn) const
 {
   // first construct the reference rotation (use 0-based numbers instead of Crisfield/Jelenic 1-based numbers)
   const idx_t I = idx_t(0.5 * (nodeCount() - 1));
   const idx_t J = idx_t(0.5 * (nodeCount() + 0));
   const double c = 0.5;
 
-  Vector phi_IJ(globalRank());
-
-  logMat(phi_IJ, matmul(Rn[I].transpose(), Rn[J]));
-  phi_IJ = c * phi_IJ;
-  expVec(Lambda_r, phi_IJ);
-  Lambda_r = matmul(Rn[I], Lambda_r);
+  Mat3 R_I;
+  Mat3 R_J;
+  Mat3 R_IJ;
+  Mat3 Exp_IJ;
+  Vec3 phi_IJ;
+
+  load(R_I, Rn[I]);
+  load(R_J, Rn[J]);
+
+  mat3TMul(R_IJ, R_I, R_J);
+  logMat(phi_IJ, R_IJ);
+  for (idx_t i = 0; i < 3; i++)
+    phi_IJ[i] *= c;
+  expVec(Exp_IJ, phi_IJ);
+  mat3Mul(Lambda_r, R_I, Exp_IJ);
 }
 
-void Line3D::getNodeRotVecs_(const Matrix psi,
-                             const Matrix Lambda_r,
-                             const Cubix Rn) const
+void Line3D::getNodeRotVecs_(const Matrix &psi,
+                             Mat3 &Lambda_r,
+                             const Cubix &Rn) const
 {
+  Mat3 R_n;
+  Mat3 R_rel;
+  Vec3 psi_n;
+
   getRefRot_(Lambda_r, Rn);
 
   for (idx_t iNode = 0; iNode < nodeCount(); iNode++)
-    logMat(psi[iNode], matmul(Lambda_r.transpose(), Rn[iNode]));
+  {
+    load(R_n, Rn[iNode]);
+    mat3TMul(R_rel, Lambda_r, R_n);
+    logMat(psi_n, R_rel);
+    store(psi[iNode], psi_n);
+  }
 }
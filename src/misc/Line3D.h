@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "utils/fixedAlgebra.h"
 #include "utils/helpers.h"
 #include <jem/util/Properties.h>
 #include <jive/Array.h>
@@ -21,6 +22,7 @@ using jive::Matrix;
 using jive::Vector;
 using jive::geom::ParametricLine;
 using jive::geom::Shape;
+using jive_helpers::Mat3;
 using jive_helpers::Quadix;
 
 /**
@@ -129,6 +131,19 @@ public:
              const Matrix &u,
              const Matrix &c) const;
 
+  /**
+   * @brief Get the Xi at the integration points from precomputed shape gradients
+   *
+   * @param[out] Xi Xi(.,.,j,i) where j are the nodes and i are the integration points
+   * @param[in] grads gradients of the shape functions (see getShapeGradients)
+   * @param[in] u displacements of the nodes, c(i,j) is the i-th displacement of the j-th node
+   * @param[in] c coordinates of the nodes, c(i,j) is the i-th coordinate of the j-th node
+   */
+  void getXi(const Quadix &Xi,
+             const Matrix &grads,
+             const Matrix &u,
+             const Matrix &c) const;
+
   /**
    * @brief Get the Psi at the integration points
    *
@@ -172,6 +187,17 @@ public:
                             const Matrix &c,
                             const Cubix &nodeLambda) const;
 
+  /**
+   * @brief Get the rotation gradients at the integration points from precomputed shape gradients
+   *
+   * @param[out] LambdaP curvature at the integration points
+   * @param[in] grads gradients of the shape functions (see getShapeGradients)
+   * @param[in] nodeLambda rotation at the nodes.
+   */
+  void getRotationGradients(const Cubix &LambdaP,
+                            const Matrix &grads,
+                            const Cubix &nodeLambda) const;
+
   /**
    * @brief Get the rotation gradients at the integration points from the rotations (Crisfield/Jelenic)
    *
@@ -227,8 +253,8 @@ private:
    * @param[out] Lambda_r Reference rotation matrix
    * @param[in] Rn Rotation matrices at the nodes
    */
-  void getRefRot_(const Matrix Lambda_r,
-                  const Cubix Rn) const;
+  void getRefRot_(Mat3 &Lambda_r,
+                  const Cubix &Rn) const;
 
   /**
    * @brief Get the local node rotation vectors according to Crisfield/Jelenic
@@ -237,9 +263,9 @@ private:
    * @param[out] Lambda_r Reference rotation matrix
    * @param[in] Rn Rotation matrices at the nodes
    */
-  void getNodeRotVecs_(const Matrix psi,
-                       const Matrix Lambda_r,
-                       const Cubix Rn) const;
+  void getNodeRotVecs_(const Matrix &psi,
+                       Mat3 &Lambda_r,
+                       const Cubix &Rn) const;
 
 protected:
   jem::Ref<ParametricLine> intLine_; ///< internal line element for some standard functions
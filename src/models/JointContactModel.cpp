@@ -6,9 +6,17 @@
 
 #include "models/JointContactModel.h"
 #include <jem/base/ClassTemplate.h>
+#include <jem/base/IllegalInputException.h>
 
 #include "utils/testing.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 using jem::newInstance;
 
 JEM_DEFINE_CLASS(JointContactModel);
@@ -24,6 +32,7 @@ const char *JointContactModel::TYPE_NAME = "JointContact";
 const char *JointContactModel::PENALTY_PROP = "penalty";
 const char *JointContactModel::RADIUS_PROP = "radius";
 const char *JointContactModel::VERBOSE_PROP = "verbose";
+const char *JointContactModel::SKIN_PROP = "skin";
 
 //-----------------------------------------------------------------------
 //   constructor
@@ -56,6 +65,15 @@ JointContactModel::JointContactModel
   jointList_.resize(joints.getNodeIndices().size());
   jointList_ = joints.getNodeIndices();
 
+  // cache the reference positions and displacement DOFs of the joints
+  const idx_t rank = allNodes_.rank();
+  jointCoords_.resize(rank, jointList_.size());
+  jointDofs_.resize(rank, jointList_.size());
+  allNodes_.getSomeCoords(jointCoords_, jointList_);
+  for (idx_t idof = 0; idof < rank; idof++)
+    dofs_->getDofIndices(jointDofs_(idof, ALL), jointList_, idof);
+  neighborsValid_ = false;
+
   // get the penalty parameter
   myProps.get(penalty_, PENALTY_PROP);
   myConf.set(PENALTY_PROP, penalty_);
@@ -64,6 +82,16 @@ JointContactModel::JointContactModel
   myProps.get(radius_, RADIUS_PROP);
   myConf.set(RADIUS_PROP, radius_);
 
+  // the radius sets the cell size of the neighbor search
+  if (radius_ <= 0.)
+    throw jem::IllegalInputException(getContext(),
+                                     String::format("%s has to be positive", RADIUS_PROP));
+
+  // get the skin distance of the neighbor list
+  skin_ = 0.5 * radius_;
+  myProps.find(skin_, SKIN_PROP, 0., 2. * radius_);
+  myConf.set(SKIN_PROP, skin_);
+
   // initialize the contact update conditions
   if (myProps.contains(PropNames::UPDATE_COND))
     FuncUtils::configCond(updCond_, PropNames::UPDATE_COND, myProps,
@@ -206,35 +234,44 @@ void JointContactModel::findContacts_
 
     (const Vector &disp)
 {
+  const idx_t rank = jointCoords_.size(0);
+  const idx_t jointCount = jointCoords_.size(1);
+
   contactsA_.clear();
   contactsB_.clear();
-  Vector posA(allNodes_.rank());
-  Vector posB(allNodes_.rank());
-  IdxVector dofsA(allNodes_.rank());
-  IdxVector dofsB(allNodes_.rank());
 
-  // iterate through the joints
-  for (idx_t ijointA = 0; ijointA < jointList_.size() - 1; ijointA++)
+  Matrix pos(rank, jointCount);
+
+  for (idx_t ijoint = 0; ijoint < jointCount; ijoint++)
+    for (idx_t idof = 0; idof < rank; idof++)
+      pos(idof, ijoint) = jointCoords_(idof, ijoint) + disp[jointDofs_(idof, ijoint)];
+
+  // rebuild the neighbor list once a joint might have moved into range
+  bool rebuild = !neighborsValid_;
+
+  for (idx_t ijoint = 0; ijoint < jointCount && !rebuild; ijoint++)
   {
-    // get the positions of the node
-    dofs_->getDofIndices(dofsA, jointList_[ijointA], IdxVector({0, 1, 2}));
-    allNodes_.getNodeCoords(posA, jointList_[ijointA]);
-    posA += disp[dofsA];
+    double dist2 = 0.;
+    for (idx_t idof = 0; idof < rank; idof++)
+      dist2 += std::pow(pos(idof, ijoint) - neighborPos_(idof, ijoint), 2);
+    rebuild = 4. * dist2 > skin_ * skin_;
+  }
 
-    for (idx_t ijointB = ijointA + 1; ijointB < jointList_.size(); ijointB++)
+  if (rebuild)
+    buildNeighbors_(pos);
+
+  // iterate through the neighboring joints
+  for (idx_t ipair = 0; ipair < neighborsA_.size(); ipair++)
+  {
+    const idx_t ijointA = neighborsA_[ipair];
+    const idx_t ijointB = neighborsB_[ipair];
+
+    // check if the nodes are in contact
+    // only consider nodes that were not in contact in the undeformed configuration
+    if (norm2(pos[ijointA] - pos[ijointB]) <= 2 * radius_ && norm2(jointCoords_[ijointA] - jointCoords_[ijointB]) > 2 * radius_)
     {
-      // get the positions of the node
-      dofs_->getDofIndices(dofsB, jointList_[ijointB], IdxVector({0, 1, 2}));
-      allNodes_.getNodeCoords(posB, jointList_[ijointB]);
-      posB += disp[dofsB];
-
-      // check if the nodes are in contact
-      // only consider nodes that were not in contact in the undeformed configuration
-      if (norm2(posA - posB) <= 2 * radius_ && norm2(posA - disp[dofsA] - (posB - disp[dofsB])) > 2 * radius_)
-      {
-        contactsA_.pushBack(ijointA);
-        contactsB_.pushBack(ijointB);
-      }
+      contactsA_.pushBack(jointList_[ijointA]);
+      contactsB_.pushBack(jointList_[ijointB]);
     }
   }
 
@@ -247,6 +284,107 @@ void JointContactModel::findContacts_
   }
 }
 
+//-----------------------------------------------------------------------
+//   buildNeighbors_
+//-----------------------------------------------------------------------
+void JointContactModel::buildNeighbors_
+
+    (const Matrix &pos)
+{
+  const idx_t rank = pos.size(0);
+  const idx_t jointCount = pos.size(1);
+  const double range = 2. * radius_ + skin_;
+
+  neighborPos_.resize(pos.shape());
+  neighborPos_ = pos;
+  neighborsValid_ = true;
+
+  if (jointCount < 2)
+  {
+    neighborsA_.resize(0);
+    neighborsB_.resize(0);
+    return;
+  }
+
+  // integer cell coordinates relative to the lower corner of all joints
+  IdxMatrix cells(rank, jointCount);
+  IdxVector cellCounts(rank);
+
+  for (idx_t idof = 0; idof < rank; idof++)
+  {
+    const double lower = min(pos(idof, ALL));
+
+    for (idx_t ijoint = 0; ijoint < jointCount; ijoint++)
+      cells(idof, ijoint) = (idx_t)std::floor((pos(idof, ijoint) - lower) / range);
+
+    cellCounts[idof] = max(cells(idof, ALL)) + 1;
+  }
+
+  // unsigned mix of the cell indices, wraps instead of overflowing for
+  // many cells; joints of colliding cells are told apart by their cells
+  auto cellKey = [rank](const idx_t *cell)
+  {
+    std::uint64_t key = 0;
+    for (idx_t idof = 0; idof < rank; idof++)
+      key ^= (std::uint64_t)cell[idof] + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    return key;
+  };
+
+  // hash the joints into their cells
+  std::unordered_map<std::uint64_t, std::vector<idx_t>> grid;
+  grid.reserve(jointCount);
+
+  for (idx_t ijoint = 0; ijoint < jointCount; ijoint++)
+    grid[cellKey(&cells(0, ijoint))].push_back(ijoint);
+
+  // compare every joint with the joints in its own and the adjacent cells
+  ArrayBuffer<idx_t> neighborsA;
+  ArrayBuffer<idx_t> neighborsB;
+  IdxVector offset(rank);
+  IdxVector cell(rank);
+  idx_t offsetCount = 1;
+
+  for (idx_t idof = 0; idof < rank; idof++)
+    offsetCount *= 3;
+
+  for (idx_t ijointA = 0; ijointA < jointCount; ijointA++)
+  {
+    for (idx_t ioffset = 0; ioffset < offsetCount; ioffset++)
+    {
+      bool inside = true;
+
+      for (idx_t idof = 0, rest = ioffset; idof < rank; idof++, rest /= 3)
+      {
+        cell[idof] = cells(idof, ijointA) + rest % 3 - 1;
+        inside &= cell[idof] >= 0 && cell[idof] < cellCounts[idof];
+      }
+
+      if (!inside)
+        continue;
+
+      auto it = grid.find(cellKey(cell.addr()));
+      if (it == grid.end())
+        continue;
+
+      for (idx_t ijointB : it->second)
+      {
+        if (ijointB <= ijointA || !jem::testall(cells(ALL, ijointB) == cell) ||
+            norm2(pos[ijointA] - pos[ijointB]) > range)
+          continue;
+
+        neighborsA.pushBack(ijointA);
+        neighborsB.pushBack(ijointB);
+      }
+    }
+  }
+
+  neighborsA_.ref(neighborsA.toArray());
+  neighborsB_.ref(neighborsB.toArray());
+
+  if (verbose_)
+    jem::System::debug(myName_) << " > > > Rebuilt neighbor list with " << neighborsA_.size() << " pairs\n";
+}
+
 //-----------------------------------------------------------------------
 //   computeContacts
 //-----------------------------------------------------------------------
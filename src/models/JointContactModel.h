@@ -28,6 +28,7 @@ using jem::Array;
 using jem::numeric::Function;
 using jem::util::ArrayBuffer;
 using jive::idx_t;
+using jive::IdxMatrix;
 using jive::IdxVector;
 using jive::Matrix;
 using jive::Properties;
@@ -59,6 +60,7 @@ public:
   static const char *PENALTY_PROP; ///< Penalty parameter
   static const char *RADIUS_PROP;  ///< Joint radius
   static const char *VERBOSE_PROP; ///< Verbose output flag
+  static const char *SKIN_PROP;    ///< Neighbor list skin distance
   /// @}
 
   /// @brief Constructor with configuration and properties
@@ -102,11 +104,23 @@ public:
 
 protected:
   /// @brief Find pairs of joints in contact
+  /// @details Only the pairs in the neighbor list are checked. The list is
+  /// rebuilt once a joint has moved more than half the skin distance since
+  /// the last build.
   /// @param disp Displacement vector of all nodes
   virtual void findContacts_
 
       (const Vector &disp);
 
+  /// @brief Build the list of joint pairs closer than the contact distance plus the skin
+  /// @details Sorts the joints into a uniform grid with cells of the
+  /// size of that distance, so only joints in neighboring cells are compared.
+  /// The cells are hashed, so the number of cells is not limited.
+  /// @param pos Current joint positions (rank x joint count)
+  virtual void buildNeighbors_
+
+      (const Matrix &pos);
+
   /// @brief Compute contact effects for detected contact pairs
   /// @param mbld Stiffness matrix builder
   /// @param fint Internal force vector
@@ -142,6 +156,16 @@ private:
   Ref<DofSpace> dofs_;              ///< Degree of freedom space
   /// @}
 
+  /// @name Neighbor list
+  /// @{
+  Matrix jointCoords_;    ///< Reference joint coordinates (rank x joint count)
+  IdxMatrix jointDofs_;   ///< Displacement DOFs of the joints (rank x joint count)
+  Matrix neighborPos_;    ///< Joint positions at the last neighbor list build
+  IdxVector neighborsA_;  ///< First joints of the neighbor pairs
+  IdxVector neighborsB_;  ///< Second joints of the neighbor pairs
+  bool neighborsValid_;   ///< Whether the neighbor list has been built
+  /// @}
+
   /// @name Contact detection
   /// @{
   ArrayBuffer<idx_t> contactsA_; ///< First nodes in contact pairs
@@ -153,6 +177,7 @@ private:
   /// @{
   double penalty_; ///< Penalty parameter for contact forces
   double radius_;  ///< Joint radius for contact detection
+  double skin_;    ///< Skin distance of the neighbor list
   bool verbose_;   ///< Enable verbose output
   /// @}
 };
@@ -5,10 +5,14 @@
  */
 
 #include "models/LatticeModel.h"
+#include "utils/SolverNames.h"
 #include "utils/testing.h"
 #include <jem/base/ClassTemplate.h>
+#include <jem/base/Float.h>
 #include <jive/app/Names.h>
 
+#include <cmath>
+
 //=======================================================================
 //   class LatticeModel
 //=======================================================================
@@ -25,6 +29,45 @@ const char *LatticeModel::JOINT_CONTACT_PROP = "jointContact";
 const char *LatticeModel::ROD_LIST_PROP = "rodList";
 const char *LatticeModel::NAME_PREFIX = "prefix";
 
+//-----------------------------------------------------------------------
+//   class TangentSum_
+//-----------------------------------------------------------------------
+
+// Applies the sum of the matrix-free tangents of all children.
+
+class LatticeModel::TangentSum_ : public AbstractMatrix
+{
+public:
+  explicit TangentSum_(const LatticeModel *model)
+      : model_(model)
+  {
+  }
+
+  virtual Shape shape() const override
+  {
+    return model_->childTangents_[0]->shape();
+  }
+
+  virtual void matmul(const Vector &lhs, const Vector &rhs) const override
+  {
+    const idx_t childCount = model_->childTangents_.size();
+
+    if (prod_.size() != lhs.size())
+      prod_.resize(lhs.size());
+
+    model_->childTangents_[0]->matmul(lhs, rhs);
+    for (idx_t ichild = 1; ichild < childCount; ichild++)
+    {
+      model_->childTangents_[ichild]->matmul(prod_, rhs);
+      lhs += prod_;
+    }
+  }
+
+private:
+  const LatticeModel *model_; // owns this operator
+  mutable Vector prod_;       // product of a single child
+};
+
 //-----------------------------------------------------------------------
 //   constructor
 //-----------------------------------------------------------------------
@@ -111,6 +154,27 @@ bool LatticeModel::takeAction
      const Properties &params,
      const Properties &globdat)
 {
+  idx_t level;
+
+  if (action == SolverNames::GET_STABLE_STEP_SIZE)
+  {
+    getStableStep(params, globdat);
+    return true;
+  }
+
+  if (action == SolverNames::GET_TANGENT_OPERATOR)
+  {
+    getTangentOperator(params, globdat);
+    return true;
+  }
+
+  if (action == Actions::GET_INT_VECTOR && childLevels_.size() == children_.size() &&
+      params.find(level, SolverNames::STEP_LEVEL))
+  {
+    getLevelForces(params, globdat, level);
+    return true;
+  }
+
   bool actionTaken = false;
   for (Ref<Model> child : children_)
     actionTaken = child->takeAction(action, params, globdat) || actionTaken;
@@ -315,6 +379,102 @@ double LatticeModel::getMass(const Properties &globdat) const
   return m;
 }
 
+//-----------------------------------------------------------------------
+//   getStableStep
+//-----------------------------------------------------------------------
+void LatticeModel::getStableStep(const Properties &params, const Properties &globdat)
+{
+  const idx_t childCount = children_.size();
+
+  Vector childDtime(childCount);
+  double dtime = jem::Float::MAX_VALUE;
+  idx_t maxLevel = 0;
+
+  params.find(dtime, SolverNames::STABLE_STEP_SIZE);
+
+  for (idx_t ichild = 0; ichild < childCount; ichild++)
+  {
+    Properties childParams;
+
+    childDtime[ichild] = jem::Float::MAX_VALUE;
+    children_[ichild]->takeAction(SolverNames::GET_STABLE_STEP_SIZE, childParams, globdat);
+    childParams.find(childDtime[ichild], SolverNames::STABLE_STEP_SIZE);
+  }
+
+  const double minDtime = jem::min(childDtime);
+
+  // every child is stable at 2^level times the smallest critical step
+  childLevels_.resize(childCount);
+  childLevels_ = 0;
+
+  if (params.find(maxLevel, SolverNames::MAX_STEP_LEVEL))
+  {
+    for (idx_t ichild = 0; ichild < childCount; ichild++)
+      childLevels_[ichild] = jem::min(maxLevel, (idx_t)std::floor(std::log2(childDtime[ichild] / minDtime)));
+
+    IdxVector levelChildren(jem::max(childLevels_) + 1);
+    levelChildren = 0;
+    for (idx_t ichild = 0; ichild < childCount; ichild++)
+      levelChildren[childLevels_[ichild]]++;
+
+    params.set(SolverNames::STEP_LEVEL, levelChildren.size() - 1);
+
+    jem::System::info(myName_) << " ...Children per step level " << levelChildren << "\n";
+  }
+
+  params.set(SolverNames::STABLE_STEP_SIZE, jem::min(dtime, minDtime));
+}
+
+//-----------------------------------------------------------------------
+//   getLevelForces
+//-----------------------------------------------------------------------
+void LatticeModel::getLevelForces(const Properties &params, const Properties &globdat, const idx_t level)
+{
+  const idx_t levelCount = jem::max(childLevels_) + 1;
+
+  Vector fint;
+  Ref<jem::Object> mass;
+
+  params.get(fint, ActionParams::INT_VECTOR);
+
+  // the level parameters refer to the columns of levelForces_, so they are
+  // only rebuilt together with them
+  if (levelForces_.size(0) != fint.size() || levelForces_.size(1) != levelCount)
+  {
+    levelForces_.resize(fint.size(), levelCount);
+    levelForces_ = 0.;
+
+    levelParams_.resize(levelCount);
+    for (idx_t ilevel = 0; ilevel < levelCount; ilevel++)
+    {
+      Properties levelParams;
+
+      levelParams.set(ActionParams::INT_VECTOR, Vector(levelForces_[ilevel]));
+      if (params.find(mass, ActionParams::MATRIX2))
+        levelParams.set(ActionParams::MATRIX2, mass);
+      levelParams_[ilevel] = levelParams;
+    }
+  }
+
+  // re-evaluate the levels starting a new step, hold the coarser ones
+  for (idx_t ilevel = 0; ilevel <= jem::min(level, levelCount - 1); ilevel++)
+  {
+    levelForces_[ilevel] = 0.;
+
+    for (idx_t ichild = 0; ichild < children_.size(); ichild++)
+      if (childLevels_[ichild] == ilevel)
+        children_[ichild]->takeAction(Actions::GET_INT_VECTOR, levelParams_[ilevel], globdat);
+  }
+
+  for (idx_t ilevel = 0; ilevel < levelCount; ilevel++)
+    fint += levelForces_[ilevel];
+
+  if (contact_)
+    contact_->takeAction(Actions::GET_INT_VECTOR, params, globdat);
+  if (jointContact_)
+    jointContact_->takeAction(Actions::GET_INT_VECTOR, params, globdat);
+}
+
 //-----------------------------------------------------------------------
 //   makeNew
 //-----------------------------------------------------------------------
@@ -335,3 +495,42 @@ void LatticeModel::declare()
 {
   ModelFactory::declare(TYPE_NAME, &makeNew);
 }
+
+//-----------------------------------------------------------------------
+//   getTangentOperator
+//-----------------------------------------------------------------------
+void LatticeModel::getTangentOperator(const Properties &params, const Properties &globdat)
+{
+  const idx_t childCount = children_.size();
+
+  Vector fint;
+
+  // the contact stiffness is only available as an assembled matrix
+  if (contact_ || jointContact_)
+    throw jem::IllegalInputException(
+        getContext(), "matrix-free tangents are not available with contact");
+
+  childTangents_.resize(childCount);
+
+  // every child overwrites the operator in its parameters
+  for (idx_t ichild = 0; ichild < childCount; ichild++)
+  {
+    Properties childParams;
+
+    if (params.find(fint, ActionParams::INT_VECTOR))
+      childParams.set(ActionParams::INT_VECTOR, fint);
+
+    if (!children_[ichild]->takeAction(SolverNames::GET_TANGENT_OPERATOR, childParams, globdat))
+      throw jem::IllegalInputException(
+          getContext(),
+          String::format("child %s has no matrix-free tangent (set matrixFree = true)",
+                         children_[ichild]->getName()));
+
+    childParams.get(childTangents_[ichild], SolverNames::TANGENT_OPERATOR);
+  }
+
+  if (!tangent_)
+    tangent_ = newInstance<TangentSum_>(this);
+
+  params.set(SolverNames::TANGENT_OPERATOR, tangent_);
+}
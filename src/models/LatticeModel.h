@@ -37,6 +37,7 @@ using jem::Ref;
 using jem::numeric::dotProduct;
 using jem::util::ArrayBuffer;
 using jive::IdxVector;
+using jive::Matrix;
 using jive::Properties;
 using jive::String;
 using jive::StringVector;
@@ -59,6 +60,16 @@ using jive::util::XTable;
 /// @details Coordinates multiple child models representing rod elements and handles
 /// contact interactions between rods and joints. Provides utilities for computing
 /// global properties like kinetic energy and total mass.
+///
+/// For subcycling integrators every child gets a step level from its critical
+/// time step, so that it is stable at 2^level base steps. Internal forces
+/// requested for a step level only re-evaluate the children up to that level
+/// and hold the forces of the coarser children from their last evaluation.
+/// The contact models always belong to the finest level.
+///
+/// For matrix-free solvers the tangent operators of all children are combined
+/// into one operator that applies their sum. This requires every child to be
+/// matrix-free and is not available with contact.
 class LatticeModel : public Model
 {
 public:
@@ -119,6 +130,22 @@ public:
   /// @param globdat Global data container
   void getMass(XTable &mass_table, const Vector &table_weights, const Properties &globdat) const;
 
+  /// @brief Compute the critical time step and the step levels of the children
+  /// @param params Action parameters
+  /// @param globdat Global data container
+  void getStableStep(const Properties &params, const Properties &globdat);
+
+  /// @brief Assemble the internal forces of a subcycling step level
+  /// @param params Action parameters
+  /// @param globdat Global data container
+  /// @param level Coarsest step level to re-evaluate
+  void getLevelForces(const Properties &params, const Properties &globdat, const idx_t level);
+
+  /// @brief Collect the matrix-free tangents of the children in one operator
+  /// @param params Action parameters
+  /// @param globdat Global data container
+  void getTangentOperator(const Properties &params, const Properties &globdat);
+
   /// @brief Factory method for creating new LatticeModel instances
   /// @param name Model name
   /// @param conf Actually used configuration properties (output)
@@ -135,6 +162,9 @@ public:
   /// @brief Register LatticeModel type with ModelFactory
   static void declare();
 
+private:
+  class TangentSum_;
+
 private:
   /// @name Child models
   /// @{
@@ -143,8 +173,17 @@ private:
   Ref<Model> jointContact_;    ///< Joint contact model
   /// @}
 
+  /// @name Subcycling
+  /// @{
+  IdxVector childLevels_;         ///< Step level of every child
+  Matrix levelForces_;            ///< Last internal forces per step level (dofs x levels)
+  Array<Properties> levelParams_; ///< Child action parameters per step level
+  /// @}
+
   /// @name System matrices
   /// @{
-  Ref<AbstractMatrix> M_; ///< Mass matrix
+  Ref<AbstractMatrix> M_;                    ///< Mass matrix
+  Array<Ref<AbstractMatrix>> childTangents_; ///< Matrix-free tangents of the children
+  Ref<AbstractMatrix> tangent_;              ///< Sum of the child tangents
   /// @}
 };
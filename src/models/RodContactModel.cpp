@@ -5,10 +5,16 @@
  */
 
 #include "models/RodContactModel.h"
+#include "utils/parallel.h"
 #include "utils/testing.h"
 
 #include <jem/base/ClassTemplate.h>
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 using jem::SliceTo;
 
 JEM_DEFINE_CLASS(RodContactModel);
@@ -27,6 +33,15 @@ const char *RodContactModel::PENALTY_NTS_PROP = "penaltyNTS";
 const char *RodContactModel::PENALTY_STS_PROP = "penaltySTS";
 const char *RodContactModel::RADIUS_PROP = "radius";
 const char *RodContactModel::VERBOSE_PROP = "verbose";
+const char *RodContactModel::SKIN_PROP = "skin";
+const char *RodContactModel::THREAD_COUNT_PROP = "threadCount";
+const char *RodContactModel::SELF_CONTACT_PROP = "selfContact";
+const char *RodContactModel::MAX_PENETRATION_PROP = "maxPenetration";
+
+const idx_t RodContactModel::MAX_PROJECTION_ITER = 20;
+const double RodContactModel::PROJECTION_TOL = 1e-12;
+const double RodContactModel::MAX_PROJECTION_COORD = 2.;
+const double RodContactModel::PROJECTION_REUSE = 1e-3;
 
 //-----------------------------------------------------------------------
 //   constructor
@@ -62,10 +77,71 @@ RodContactModel::RodContactModel
     rodList_[iRod] = ElementGroup::get(rodNames[iRod], allElems_, globdat, getContext());
   }
 
+  // Collect the elements and nodes of all rods for the contact search
+  ArrayBuffer<idx_t> rodElems;
+  ArrayBuffer<idx_t> rodElemRods;
+  rodNodes_.resize(rodList_.size());
+  for (idx_t iRod = 0; iRod < rodList_.size(); iRod++)
+  {
+    const IdxVector elems = rodList_[iRod].getIDs();
+
+    rodElems.pushBack(elems.begin(), elems.end());
+    for (idx_t i = 0; i < elems.size(); i++)
+      rodElemRods.pushBack(iRod);
+
+    rodNodes_[iRod].ref(rodList_[iRod].getNodeIndices().clone());
+    std::sort(rodNodes_[iRod].addr(), rodNodes_[iRod].addr() + rodNodes_[iRod].size());
+  }
+  rodElems_.ref(rodElems.toArray());
+  rodElemRods_.ref(rodElemRods.toArray());
+
+  // Collect the translational DOFs of all rod nodes
+  ArrayBuffer<idx_t> rodNodes;
+  for (idx_t iRod = 0; iRod < rodList_.size(); iRod++)
+    rodNodes.pushBack(rodNodes_[iRod].begin(), rodNodes_[iRod].end());
+
+  IdxVector allRodNodes(rodNodes.toArray());
+  idx_t *rodNodesEnd = allRodNodes.addr() + allRodNodes.size();
+  std::sort(allRodNodes.addr(), rodNodesEnd);
+  allRodNodes.ref(allRodNodes[SliceTo(std::unique(allRodNodes.addr(), rodNodesEnd) - allRodNodes.addr())].clone());
+
+  rodDofs_.resize(allNodes_.rank(), allRodNodes.size());
+  for (idx_t idof = 0; idof < allNodes_.rank(); idof++)
+    dofs_->getDofIndices(rodDofs_(idof, ALL), allRodNodes, idof);
+
   // Initialize the internal shape.
   myProps.makeProps("shape").set("numPoints", allElems_.maxElemNodeCount());
   shape_ = newInstance<Line3D>("shape", myConf, myProps);
 
+  // find the element nodes at the ends of the local coordinate range
+  Vector h(shape_->nodeCount());
+  endNodes_.resize(2);
+
+  for (idx_t iEnd = 0; iEnd < 2; iEnd++)
+  {
+    shape_->evalShapeFunctions(h, Vector({iEnd ? 1. : -1.}));
+    endNodes_[iEnd] = 0;
+    for (idx_t iNode = 1; iNode < h.size(); iNode++)
+      if (h[iNode] > h[endNodes_[iEnd]])
+        endNodes_[iEnd] = iNode;
+  }
+
+  // curved centerlines can leave the hull of their nodes, by at most
+  // (L - 1)/2 times the node spread with the Lebesgue constant L of the
+  // shape functions (sampled, the maximum is smooth)
+  double lebesgue = 1.;
+
+  for (idx_t iSample = 0; iSample <= 1000; iSample++)
+  {
+    double hSum = 0.;
+
+    shape_->evalShapeFunctions(h, Vector({-1. + 2e-3 * (double)iSample}));
+    for (idx_t iNode = 0; iNode < h.size(); iNode++)
+      hSum += std::abs(h[iNode]);
+    lebesgue = jem::max(lebesgue, hSum);
+  }
+  hullOvershoot_ = 0.5 * (lebesgue - 1.);
+
   // get the penalty parameter
   if (!(myProps.find(penaltySTS_, PENALTY_STS_PROP) && myProps.find(penaltyNTS_, PENALTY_NTS_PROP)))
   {
@@ -80,6 +156,11 @@ RodContactModel::RodContactModel
   myProps.get(radius_, RADIUS_PROP);
   myConf.set(RADIUS_PROP, radius_);
 
+  // get the skin distance of the candidate lists
+  skin_ = 0.5 * radius_;
+  myProps.find(skin_, SKIN_PROP, 0., 2. * radius_);
+  myConf.set(SKIN_PROP, skin_);
+
   // initialize the contact update conditions
   if (myProps.contains(PropNames::UPDATE_COND))
     FuncUtils::configCond(updCond_, PropNames::UPDATE_COND, myProps,
@@ -91,10 +172,33 @@ RodContactModel::RodContactModel
   contactsA_.clear();
   contactsB_.clear();
 
+  // get whether elements of the same rod can get into contact
+  selfContact_ = false;
+  myProps.find(selfContact_, SELF_CONTACT_PROP);
+  myConf.set(SELF_CONTACT_PROP, selfContact_);
+
+  // get the accepted penetration (as a fraction of the radius)
+  maxPenetrationFraction_ = 0.;
+  myProps.find(maxPenetrationFraction_, MAX_PENETRATION_PROP, 0., 2.);
+  myConf.set(MAX_PENETRATION_PROP, maxPenetrationFraction_);
+
+  contactEnergy_ = 0.;
+  maxPenetration_ = 0.;
+  evaluated_ = false;
+
+  // get the number of threads for the narrow phase
+  threadCount_ = 1;
+  myProps.find(threadCount_, THREAD_COUNT_PROP, 0, 1024);
+  if (threadCount_ == 0)
+    threadCount_ = jive_helpers::maxThreadCount();
+  myConf.set(THREAD_COUNT_PROP, threadCount_);
+
   // get the verbosity
   verbose_ = false;
   myProps.find(verbose_, VERBOSE_PROP);
   myConf.set(VERBOSE_PROP, verbose_);
+
+  initPairWork_();
 }
 
 //-----------------------------------------------------------------------
@@ -121,6 +225,12 @@ bool RodContactModel::takeAction
     // build the contact blacklist
     computeBlacklist_(elemsA, elemsB, disp);
 
+    // nothing is in contact before the first converged step
+    committedForce_.resize(disp.size());
+    committedForce_ = 0.;
+    committedEnergy_.resize(allNodes_.size());
+    committedEnergy_ = 0.;
+
     return true;
   }
 
@@ -150,7 +260,10 @@ bool RodContactModel::takeAction
     // get the load case
     globdat.find(loadCase, jive::app::PropNames::LOAD_CASE);
 
-    if (FuncUtils::evalCond(*updCond_, globdat) || loadCase != "output")
+    // only an evaluation of all candidates can be reused for the commit
+    evaluated_ = FuncUtils::evalCond(*updCond_, globdat) || loadCase != "output";
+
+    if (evaluated_)
     {
       // find possible contacts if they need to be updated
       findContacts_(elemsA, elemsB, disp);
@@ -164,17 +277,44 @@ bool RodContactModel::takeAction
       elemsB = contactsB_.toArray();
     }
 
-    if (elemsA.size() == 0) // skip the computation if no actual contact possible
+    // Compute the contact effects
+    computeContacts_(*mbld, fint, elemsA, elemsB, disp);
+
+    if (evaluated_)
     {
-      return true;
+      evalDisp_.resize(disp.size());
+      evalDisp_ = disp;
     }
 
-    // Compute the contact effects
-    computeContacts_(*mbld, fint, elemsA, elemsB, disp);
+    return true;
+  }
+
+  if (action == Actions::CHECK_COMMIT && maxPenetrationFraction_ > 0.)
+  {
+    Vector disp;
+    bool accept = true;
+
+    StateVector::get(disp, dofs_, globdat);
+    if (!isEvaluatedAt_(disp))
+      updateContactState_(disp);
+
+    // only ever lower the acceptance, without other models deciding the
+    // step has to be converged
+    if (!params.find(accept, ActionParams::ACCEPT))
+      SolverInfo::get(globdat).find(accept, SolverInfo::CONVERGED);
+    if (maxPenetration_ > maxPenetrationFraction_ * radius_)
+    {
+      jem::System::info(myName_) << " ...Contact penetration " << maxPenetration_ << " too deep, rejecting step\n";
+      accept = false;
+    }
+    params.set(ActionParams::ACCEPT, accept);
 
     return true;
   }
 
+  if (action == Actions::ADVANCE || action == Actions::CANCEL)
+    evaluated_ = false;
+
   if (action == Actions::GET_TABLE)
   {
     Ref<XTable> table;
@@ -187,6 +327,25 @@ bool RodContactModel::takeAction
 
     IdxVector jtypes(3);
 
+    if (name == "potentialEnergy" || name == "contactEnergy")
+    {
+      if (table->getRowItems() != allNodes_.getData())
+        return false;
+
+      const idx_t jCol = table->addColumn(name);
+
+      for (idx_t inode = 0; inode < committedEnergy_.size(); inode++)
+      {
+        if (committedEnergy_[inode] == 0.)
+          continue;
+
+        table->addValue(inode, jCol, committedEnergy_[inode]);
+        weights[inode] = 1.;
+      }
+
+      return true;
+    }
+
     if (name == "F_contact")
     {
       jtypes = table->addColumns(dofs_->getTypeNames()[SpecialCosseratRodModel::TRANS_PART]);
@@ -200,30 +359,14 @@ bool RodContactModel::takeAction
       return false;
     }
 
-    // Get the current displacements.
-    Vector disp;
-    StateVector::get(disp, dofs_, globdat);
-
-    // Compute the contact effects
-    Ref<MatrixBuilder> mbld;
-    mbld = newInstance<NullMatrixBuilder>();
-
-    Vector fint(disp.size());
-    fint = 0.;
-
-    if (contactsA_.toArray().size() != 0) // skip the computation if no actual contact possible
-    {
-      computeContacts_(*mbld, fint, contactsA_.toArray(), contactsB_.toArray(), disp);
-    }
-
-    // Add the contact forces to the table
+    // Add the contact forces of the last converged state to the table
     IdxVector jdofs(jtypes.size());
 
     // iterate through the nodes
     for (idx_t inode : IdxVector(jem::iarray(allNodes_.size())))
     {
       dofs_->getDofIndices(jdofs, inode, jtypes);
-      table->addRowValues(inode, jtypes, Vector(fint[jdofs]));
+      table->addRowValues(inode, jtypes, Vector(committedForce_[jdofs]));
     }
 
     weights = -1.;
@@ -233,7 +376,27 @@ bool RodContactModel::takeAction
 
   if (action == Actions::COMMIT)
   {
-    // LATER add contact stiffness to potential energy!!
+    Properties vars = Globdat::getVariables(globdat);
+    Vector disp;
+    double E_pot = 0.;
+
+    // reuse the last evaluation if it was made at the converged state
+    StateVector::get(disp, dofs_, globdat);
+    if (!isEvaluatedAt_(disp))
+      updateContactState_(disp);
+    evaluated_ = false;
+
+    vars.find(E_pot, "potentialEnergy");
+    vars.set("potentialEnergy", E_pot + contactEnergy_);
+    vars.set("contactEnergy", contactEnergy_);
+
+    // keep the converged results for the output
+    committedForce_.resize(contactForce_.size());
+    committedForce_ = contactForce_;
+    committedEnergy_.resize(nodeEnergy_.size());
+    committedEnergy_ = nodeEnergy_;
+
+    return true;
   }
 
   return false;
@@ -246,203 +409,165 @@ void RodContactModel::findContacts_
 
     (IdxVector &elementsA,
      IdxVector &elementsB,
-     const Vector &disp) const
+     const Vector &disp)
 {
-  IdxVector beamsA;
-  IdxVector beamsB;
-  // store the possible contact Pairs
-  ArrayBuffer<idx_t> beamAElements;
-  ArrayBuffer<idx_t> beamBElements;
+  const idx_t rodNodeCount = rodDofs_.size(1);
 
-  findPossibleBeams_(beamsA, beamsB, disp);
+  // rebuild the candidates once two elements might have moved into range
+  bool rebuild = candidateDisp_.size(1) != rodNodeCount;
 
-  for (idx_t i = 0; i < beamsA.size(); i++)
+  for (idx_t inode = 0; inode < rodNodeCount && !rebuild; inode++)
   {
-    IdxVector contactAElements;
-    IdxVector contactBElements;
+    double dist2 = 0.;
+    for (idx_t idof = 0; idof < rodDofs_.size(0); idof++)
+      dist2 += std::pow(disp[rodDofs_(idof, inode)] - candidateDisp_(idof, inode), 2);
+    rebuild = 4. * dist2 > skin_ * skin_;
+  }
 
-    findPossibleElements_(contactAElements, contactBElements, beamsA[i], beamsB[i], disp);
+  if (rebuild)
+  {
+    buildCandidates_(disp);
 
-    beamAElements.pushBack(contactAElements.begin(), contactAElements.end());
-    beamBElements.pushBack(contactBElements.begin(), contactBElements.end());
+    candidateDisp_.resize(rodDofs_.shape());
+    for (idx_t inode = 0; inode < rodNodeCount; inode++)
+      for (idx_t idof = 0; idof < rodDofs_.size(0); idof++)
+        candidateDisp_(idof, inode) = disp[rodDofs_(idof, inode)];
   }
 
-  elementsA.ref(beamAElements.toArray());
-  elementsB.ref(beamBElements.toArray());
+  elementsA.ref(candidatesA_);
+  elementsB.ref(candidatesB_);
 }
 
 //-----------------------------------------------------------------------
-//   findPossibleBeams_
+//   buildCandidates_
 //-----------------------------------------------------------------------
+void RodContactModel::buildCandidates_
 
-void RodContactModel::findPossibleBeams_
-
-    (IdxVector &beamsA,
-     IdxVector &beamsB,
-     const Vector &disp) const
+    (const Vector &disp)
 {
   const idx_t nodeCount = shape_->nodeCount();
-  const idx_t globalRank = shape_->globalRank();
 
-  // store the possible contact Pairs
-  ArrayBuffer<idx_t> beamACandidates;
-  ArrayBuffer<idx_t> beamBCandidates;
+  ArrayBuffer<idx_t> itemsA;
+  ArrayBuffer<idx_t> itemsB;
 
-  // Get the boxes of the rods
-  Matrix elemBoxA(globalRank, 2);
-  Matrix elemBoxB(globalRank, 2);
-  // IdxVector dofsA(nodeCount);
-  IdxVector dofsB(nodeCount);
-  // Matrix possA(globalRank, 0);
-  Matrix possB(globalRank, 0);
-  bool cornerCheck = false;
+  // refit the hierarchy to the current configuration and query it
+  elemBoxes_.resize(2 * shape_->globalRank(), rodElems_.size());
+  getElemBoxes_(elemBoxes_, disp);
+  tree_.update(elemBoxes_);
+  tree_.findOverlaps(itemsA, itemsB);
 
-  possB.resize(globalRank, rodList_[0].getNodeIndices().size());
-  allNodes_.getSomeCoords(possB, rodList_[0].getNodeIndices());
+  // keep the element pairs of different rods (and of the same rod for
+  // self-contact), with side A on the lower rod
+  std::vector<std::pair<idx_t, idx_t>> pairs;
+  pairs.reserve(itemsA.size());
 
-  dofsB.resize(rodList_[0].getNodeIndices().size());
-  for (idx_t idof = 0; idof < globalRank; idof++)
+  for (idx_t i = 0; i < itemsA.size(); i++)
   {
-    dofs_->getDofIndices(dofsB, rodList_[0].getNodeIndices(), idof);
-    possB(idof, ALL) += disp[dofsB];
-  }
+    idx_t itemA = itemsA[i];
+    idx_t itemB = itemsB[i];
 
-  for (idx_t idof = 0; idof < globalRank; idof++)
-  {
-    elemBoxB(idof, 0) = min(possB(idof, ALL)) - radius_;
-    elemBoxB(idof, 1) = max(possB(idof, ALL)) + radius_;
+    if (rodElemRods_[itemA] == rodElemRods_[itemB] && !selfContact_)
+      continue;
+    if (rodElemRods_[itemA] > rodElemRods_[itemB])
+      std::swap(itemA, itemB);
+
+    pairs.emplace_back(itemA, itemB);
   }
 
-  for (idx_t iRod = 0; iRod < rodList_.size(); iRod++)
+  // report the pairs in the order of the rod element lists
+  std::sort(pairs.begin(), pairs.end());
+
+  ArrayBuffer<idx_t> beamAElements;
+  ArrayBuffer<idx_t> beamBElements;
+  IdxVector nodesA(nodeCount);
+  IdxVector nodesB(nodeCount);
+
+  for (const auto &pair : pairs)
   {
-    elemBoxA = elemBoxB.clone();
+    const IdxVector &rodNodesA = rodNodes_[rodElemRods_[pair.first]];
+    const IdxVector &rodNodesB = rodNodes_[rodElemRods_[pair.second]];
+    const idx_t *beginA = rodNodesA.addr();
+    const idx_t *beginB = rodNodesB.addr();
+    bool connected = false;
 
-    for (idx_t jRod = rodList_.size() - 1; jRod > iRod; jRod--)
+    allElems_.getElemNodes(nodesA, rodElems_[pair.first]);
+    allElems_.getElemNodes(nodesB, rodElems_[pair.second]);
+
+    if (rodElemRods_[pair.first] == rodElemRods_[pair.second])
     {
-      possB.reshape(globalRank, rodList_[jRod].getNodeIndices().size());
-      allNodes_.getSomeCoords(possB, rodList_[jRod].getNodeIndices());
+      // skip adjacent elements of the same rod
+      for (idx_t inode = 0; inode < nodeCount && !connected; inode++)
+        connected = jem::testany(nodesA[inode] == nodesB);
+    }
+    else
+    {
+      // skip elements sharing a node with the other rod
+      for (idx_t inode = 0; inode < nodeCount && !connected; inode++)
+        connected = std::binary_search(beginB, beginB + rodNodesB.size(), nodesA[inode]) ||
+                    std::binary_search(beginA, beginA + rodNodesA.size(), nodesB[inode]);
+    }
 
-      dofsB.resize(rodList_[jRod].getNodeIndices().size());
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        dofs_->getDofIndices(dofsB, rodList_[jRod].getNodeIndices(), idof);
-        possB(idof, ALL) += disp[dofsB];
-      }
+    if (connected)
+      continue;
 
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        elemBoxB(idof, 0) = min(possB(idof, ALL)) - radius_;
-        elemBoxB(idof, 1) = max(possB(idof, ALL)) + radius_;
-      }
+    beamAElements.pushBack(rodElems_[pair.first]);
+    beamBElements.pushBack(rodElems_[pair.second]);
+  }
 
-      cornerCheck = true;
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        cornerCheck &= elemBoxA(idof, 1) >= elemBoxB(idof, 0) && elemBoxB(idof, 1) >= elemBoxA(idof, 0);
-      }
+  candidatesA_.ref(beamAElements.toArray());
+  candidatesB_.ref(beamBElements.toArray());
 
-      if (cornerCheck)
-      {
-        beamACandidates.pushBack(iRod);
-        beamBCandidates.pushBack(jRod);
-      }
-    }
+  // keep the closest points of the pairs that are still candidates
+  std::unordered_map<std::uint64_t, ContactPoint_> contactPoints;
+
+  for (idx_t i = 0; i < candidatesA_.size(); i++)
+  {
+    auto point = contactPoints_.find(contactKey_(candidatesA_[i], candidatesB_[i]));
+
+    if (point != contactPoints_.end())
+      contactPoints.insert(*point);
   }
 
-  beamsA.resize(beamACandidates.size());
-  beamsA = beamACandidates.toArray();
-  beamsB.resize(beamBCandidates.size());
-  beamsB = beamBCandidates.toArray();
+  contactPoints_.swap(contactPoints);
+
+  if (verbose_)
+    jem::System::debug(myName_) << " > > > > Rebuilt contact candidates with " << candidatesA_.size() << " pairs\n";
 }
 
 //-----------------------------------------------------------------------
-//   findPossibleElements_
+//   getElemBoxes_
 //-----------------------------------------------------------------------
-void RodContactModel::findPossibleElements_
 
-    (IdxVector &elemsA,
-     IdxVector &elemsB,
-     const idx_t &beamA,
-     const idx_t &beamB,
+void RodContactModel::getElemBoxes_
+
+    (const Matrix &boxes,
      const Vector &disp) const
 {
   const idx_t nodeCount = shape_->nodeCount();
   const idx_t globalRank = shape_->globalRank();
 
-  // store the possible contact Pairs
-  ArrayBuffer<idx_t> beamACandidates;
-  ArrayBuffer<idx_t> beamBCandidates;
-
-  // Get the boxes of the rods
-  Matrix elemBoxA(globalRank, 2);
-  Matrix elemBoxB(globalRank, 2);
-  IdxVector nodesA(nodeCount);
-  IdxVector nodesB(nodeCount);
-  IdxVector dofsA(nodeCount);
-  IdxVector dofsB(nodeCount);
-  Matrix possA(globalRank, nodeCount);
-  Matrix possB(globalRank, nodeCount);
-  bool cornerCheck = false;
+  IdxVector nodes(nodeCount);
+  IdxVector idofs(nodeCount);
+  Matrix poss(globalRank, nodeCount);
 
-  // iterate over the elements
-  for (idx_t iElemA : rodList_[beamA].getIDs())
+  for (idx_t ie = 0; ie < rodElems_.size(); ie++)
   {
-    allElems_.getElemNodes(nodesA, iElemA);
-    allNodes_.getSomeCoords(possA, nodesA);
-
-    if (jem::testany(nodesA[0] == rodList_[beamB].getNodeIndices()) || jem::testany(nodesA[1] == rodList_[beamB].getNodeIndices())) // LATER higher order elements
-      continue;
-
-    for (idx_t idof = 0; idof < 3; idof++)
-    {
-      dofs_->getDofIndices(dofsA, nodesA, idof);
-      possA(idof, ALL) += disp[dofsA];
-    }
+    allElems_.getElemNodes(nodes, rodElems_[ie]);
+    allNodes_.getSomeCoords(poss, nodes);
 
     for (idx_t idof = 0; idof < globalRank; idof++)
     {
-      elemBoxA(idof, 0) = min(possA(idof, ALL)) - radius_;
-      elemBoxA(idof, 1) = max(possA(idof, ALL)) + radius_;
-    }
-
-    for (idx_t iElemB : rodList_[beamB].getIDs())
-    {
-      allElems_.getElemNodes(nodesB, iElemB);
-      allNodes_.getSomeCoords(possB, nodesB);
-
-      if (jem::testany(nodesB[0] == rodList_[beamA].getNodeIndices()) || jem::testany(nodesB[1] == rodList_[beamA].getNodeIndices())) // LATER higher order elements
-        continue;
+      dofs_->getDofIndices(idofs, nodes, idof);
+      poss(idof, ALL) += disp[idofs];
 
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        dofs_->getDofIndices(dofsB, nodesB, idof);
-        possB(idof, ALL) += disp[dofsB];
-      }
+      const double lower = min(poss(idof, ALL));
+      const double upper = max(poss(idof, ALL));
+      const double margin = hullOvershoot_ * (upper - lower) + radius_ + 0.5 * skin_;
 
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        elemBoxB(idof, 0) = min(possB(idof, ALL)) - radius_;
-        elemBoxB(idof, 1) = max(possB(idof, ALL)) + radius_;
-      }
-
-      cornerCheck = true;
-      for (idx_t idof = 0; idof < globalRank; idof++)
-      {
-        cornerCheck &= elemBoxA(idof, 1) >= elemBoxB(idof, 0) && elemBoxB(idof, 1) >= elemBoxA(idof, 0);
-      }
-
-      if (cornerCheck)
-      {
-        beamACandidates.pushBack(iElemA);
-        beamBCandidates.pushBack(iElemB);
-      }
+      boxes(idof, ie) = lower - margin;
+      boxes(globalRank + idof, ie) = upper + margin;
     }
   }
-
-  elemsA.resize(beamACandidates.size());
-  elemsA = beamACandidates.toArray();
-  elemsB.resize(beamBCandidates.size());
-  elemsB = beamBCandidates.toArray();
 }
 
 //-----------------------------------------------------------------------
@@ -456,8 +581,13 @@ void RodContactModel::computeContacts_
      const IdxVector &elementsB,
      const Vector &disp)
 {
+  const idx_t contactCount = elementsA.size();
   const idx_t nodeCount = shape_->nodeCount();
   const idx_t globalRank = shape_->globalRank();
+  const idx_t maxDofCount = 2 * nodeCount * globalRank;
+  // the debug output of the pairs is only readable in order
+  const idx_t threadCount = verbose_ ? 1 : threadCount_;
+  const idx_t chunkSize = jem::max(jem::min(contactCount, 32 * threadCount), (idx_t)1);
 
   if (verbose_)
   {
@@ -469,272 +599,488 @@ void RodContactModel::computeContacts_
     jem::System::debug(myName_) << "\n";
   }
 
-  IdxVector nodesA(nodeCount);
-  IdxVector nodesB(nodeCount);
-  Matrix possA(globalRank, nodeCount);
-  Matrix possB(globalRank, nodeCount);
-  IdxMatrix dofsA(globalRank, nodeCount);
-  IdxMatrix dofsB(globalRank, nodeCount);
-  IdxVector dofsAB(globalRank * nodeCount * 2);
+  // PER PAIR BUFFERS
+  Cubix pairK(maxDofCount, maxDofCount, chunkSize);
+  Matrix pairF(maxDofCount, chunkSize);
+  IdxMatrix pairDofs(maxDofCount, chunkSize);
+  IdxVector pairDofCount(chunkSize);
+  Matrix pairU(2, chunkSize);
+  Cubix pairPoss(globalRank, 2 * nodeCount, chunkSize);
+  Matrix pairE(2, chunkSize);
+  IdxVector nodes(nodeCount);
+
+  contactEnergy_ = 0.;
+  maxPenetration_ = 0.;
+  nodeEnergy_.resize(allNodes_.size());
+  nodeEnergy_ = 0.;
+  contactForce_.resize(fint.size());
+  contactForce_ = 0.;
+
+  // iterate through the pairs chunk by chunk
+  for (idx_t i0 = 0; i0 < contactCount; i0 += chunkSize)
+  {
+    const idx_t i1 = jem::min(i0 + chunkSize, contactCount);
+
+    // evaluate the pairs of this chunk (possibly concurrently)
+    jive_helpers::parallelFor(i0, i1, threadCount, [&](const idx_t iContact)
+                              { pairDofCount[iContact - i0] =
+                                    computePair_(pairF[iContact - i0], pairK[iContact - i0],
+                                                 pairDofs[iContact - i0], pairU[iContact - i0],
+                                                 pairPoss[iContact - i0], pairE(0, iContact - i0),
+                                                 pairE(1, iContact - i0), elementsA[iContact],
+                                                 elementsB[iContact], disp); });
+
+    // scatter the closed contacts in pair order, so the result does not
+    // depend on the number of threads
+    for (idx_t iContact = i0; iContact < i1; iContact++)
+    {
+      const idx_t dofCount = pairDofCount[iContact - i0];
+
+      if (dofCount >= 0 && !std::isnan(pairU(0, iContact - i0))) // the pair has been projected
+      {
+        ContactPoint_ &point = contactPoints_[contactKey_(elementsA[iContact], elementsB[iContact])];
+
+        point.uA = pairU(0, iContact - i0);
+        point.uB = pairU(1, iContact - i0);
+        point.poss.resize(globalRank, 2 * nodeCount);
+        point.poss = pairPoss[iContact - i0];
+      }
+
+      if (dofCount <= 0)
+        continue;
+
+      const IdxVector dofsAB = pairDofs[iContact - i0][SliceTo(dofCount)];
+
+      fint[dofsAB] += pairF[iContact - i0][SliceTo(dofCount)];
+      contactForce_[dofsAB] += pairF[iContact - i0][SliceTo(dofCount)];
+      mbld.addBlock(dofsAB, dofsAB, pairK[iContact - i0](SliceTo(dofCount), SliceTo(dofCount)));
+
+      contactsA_.pushBack(elementsA[iContact]);
+      contactsB_.pushBack(elementsB[iContact]);
+
+      // split the penalty energy evenly over the nodes of both elements
+      contactEnergy_ += pairE(0, iContact - i0);
+      maxPenetration_ = jem::max(maxPenetration_, pairE(1, iContact - i0));
+
+      for (idx_t elem : {elementsA[iContact], elementsB[iContact]})
+      {
+        allElems_.getElemNodes(nodes, elem);
+        nodeEnergy_[nodes] += 0.5 * pairE(0, iContact - i0) / (double)nodeCount;
+      }
+    }
+  }
+
+  if (verbose_)
+    jem::System::debug(myName_) << " > > > > Done computing contacts\n";
+}
+
+//-----------------------------------------------------------------------
+//   updateContactState_
+//-----------------------------------------------------------------------
+void RodContactModel::updateContactState_
+
+    (const Vector &disp)
+{
+  Ref<MatrixBuilder> mbld = newInstance<NullMatrixBuilder>();
+  Vector fint(disp.size());
+  IdxVector elemsA;
+  IdxVector elemsB;
+
+  fint = 0.;
+
+  findContacts_(elemsA, elemsB, disp);
+  contactsA_.clear();
+  contactsB_.clear();
+
+  computeContacts_(*mbld, fint, elemsA, elemsB, disp);
+
+  evaluated_ = true;
+  evalDisp_.resize(disp.size());
+  evalDisp_ = disp;
+}
+
+//-----------------------------------------------------------------------
+//   isEvaluatedAt_
+//-----------------------------------------------------------------------
+bool RodContactModel::isEvaluatedAt_
+
+    (const Vector &disp) const
+{
+  // explicit integrators move the state after the force evaluation
+  return evaluated_ && evalDisp_.size() == disp.size() &&
+         jem::testall(evalDisp_ == disp);
+}
+
+//-----------------------------------------------------------------------
+//   computePair_
+//-----------------------------------------------------------------------
+idx_t RodContactModel::computePair_
+
+    (const Vector &f_pair,
+     const Matrix &k_pair,
+     const IdxVector &dofs_pair,
+     const Vector &u_pair,
+     const Matrix &poss_pair,
+     double &energy_pair,
+     double &penetration_pair,
+     const idx_t elementA,
+     const idx_t elementB,
+     const Vector &disp) const
+{
+  const idx_t nodeCount = shape_->nodeCount();
+  const idx_t globalRank = shape_->globalRank();
+
+  const idx_t stsDofCount = 2 * nodeCount * globalRank;
+  const idx_t ntsDofCount = (nodeCount + 1) * globalRank;
+
+  PairWork_ &work = getPairWork_();
+  const IdxVector nodesA = work.nodesA;
+  const IdxVector nodesB = work.nodesB;
+  const Matrix possA = work.possA;
+  const Matrix possB = work.possB;
+  const IdxMatrix dofsA = work.dofsA;
+  const IdxMatrix dofsB = work.dofsB;
 
   double uA = 0; // local coordinates
   double uB = 0;
 
+  // the contributions are assembled in place in the pair buffers
+  idx_t dofCount = 0;
+  IdxVector dofsAB;
   Vector f_contrib;
   Matrix k_contrib;
 
+  bool projected = true;
+  bool reused = false;
+  idx_t iterCount = 0;
   bool contact_closed;
+  double penetration = 0.;
 
-  for (idx_t iContact = 0; iContact < elementsA.size(); iContact++)
+  // accumulate the penalty energy and the deepest penetration of the pair
+  auto addPenetration = [&](const double penalty)
   {
-    allElems_.getElemNodes(nodesA, elementsA[iContact]);
-    allNodes_.getSomeCoords(possA, nodesA);
-    allElems_.getElemNodes(nodesB, elementsB[iContact]);
-    allNodes_.getSomeCoords(possB, nodesB);
+    energy_pair += 0.5 * penalty * penetration * penetration;
+    penetration_pair = jem::max(penetration_pair, penetration);
+  };
 
-    if (nodesA[0] == nodesB[0] || nodesA[0] == nodesB[1] || nodesA[1] == nodesB[0] || nodesA[1] == nodesB[1]) // LATER higher order elements
-    {
-      if (verbose_)
-        jem::System::debug(myName_) << " > > Skipping contact between elements " << elementsA[iContact] << " and " << elementsB[iContact] << " (same nodes)\n";
-      continue;
-    }
+  auto useContribs = [&](const idx_t count)
+  {
+    dofCount = count;
+    dofsAB.ref(dofs_pair[SliceTo(count)]);
+    f_contrib.ref(f_pair[SliceTo(count)]);
+    f_contrib = 0.;
+    k_contrib.ref(k_pair(SliceTo(count), SliceTo(count)));
+    k_contrib = 0.;
+  };
+
+  auto containsLocalPoint = [&](const double u)
+  {
+    work.point[0] = u;
+    return shape_->containsLocalPoint(work.point);
+  };
 
-    if (filterBlacklist_(elementsA[iContact], elementsB[iContact]))
-    {
-      if (verbose_)
-        jem::System::debug(myName_) << " > > Skipping contact between elements " << elementsA[iContact] << " and " << elementsB[iContact] << " (blacklisted)\n";
-      continue;
-    }
+  energy_pair = 0.;
+  penetration_pair = 0.;
 
-    for (idx_t iNode = 0; iNode < nodeCount; iNode++)
-    {
-      dofs_->getDofIndices(dofsA[iNode], nodesA[iNode], IdxVector({0, 1, 2}));
-      possA[iNode] += disp[dofsA[iNode]];
-      dofs_->getDofIndices(dofsB[iNode], nodesB[iNode], IdxVector({0, 1, 2}));
-      possB[iNode] += disp[dofsB[iNode]];
-    }
+  allElems_.getElemNodes(nodesA, elementA);
+  allNodes_.getSomeCoords(possA, nodesA);
+  allElems_.getElemNodes(nodesB, elementB);
+  allNodes_.getSomeCoords(possB, nodesB);
 
-    findClosestPoints_(uA, uB, possA, possB);
+  if (shareNodes_(nodesA, nodesB))
+  {
+    if (verbose_)
+      jem::System::debug(myName_) << " > > Skipping contact between elements " << elementA << " and " << elementB << " (same nodes)\n";
+    return -1;
+  }
 
+  if (filterBlacklist_(elementA, elementB))
+  {
     if (verbose_)
-      jem::System::debug(myName_) << " > > Contact detection between elements " << elementsA[iContact] << " and " << elementsB[iContact]
-                                  << " at local coordinates " << uA << " and " << uB << "\n     ==} ";
+      jem::System::debug(myName_) << " > > Skipping contact between elements " << elementA << " and " << elementB << " (blacklisted)\n";
+    return -1;
+  }
 
-    contact_closed = false;
+  for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+  {
+    dofs_->getDofIndices(dofsA[iNode], nodesA[iNode], work.transTypes);
+    possA[iNode] += disp[dofsA[iNode]];
+    dofs_->getDofIndices(dofsB[iNode], nodesB[iNode], work.transTypes);
+    possB[iNode] += disp[dofsB[iNode]];
+  }
+
+  poss_pair[SliceTo(nodeCount)] = possA;
+  poss_pair[SliceFrom(nodeCount)] = possB;
+
+  // start from the closest points of the last projection of this pair
+  auto point = contactPoints_.find(contactKey_(elementA, elementB));
+
+  if (point != contactPoints_.end())
+  {
+    const Matrix &possOld = point->second.poss;
+    double moved = 0.;
+
+    uA = point->second.uA;
+    uB = point->second.uB;
 
-    if (shape_->containsLocalPoint(Vector({uA})) && shape_->containsLocalPoint(Vector({uB})))
+    // only converged projections are kept, so a stored point stays usable
+    // while the nodes moved less than a small fraction of the element length
+    for (idx_t iNode = 0; iNode < 2 * nodeCount; iNode++)
     {
-      if (verbose_)
-        jem::System::debug(myName_) << "STS contact ";
-      // LATER higher order elements
-      dofsAB.resize(globalRank * 4);
+      double dist = 0.;
+      for (idx_t i = 0; i < globalRank; i++)
+        dist += (poss_pair(i, iNode) - possOld(i, iNode)) * (poss_pair(i, iNode) - possOld(i, iNode));
+      moved = jem::max(moved, std::sqrt(dist));
+    }
 
-      f_contrib.resize(2 * nodeCount * globalRank);
-      f_contrib = 0.;
-      k_contrib.resize(2 * nodeCount * globalRank, 2 * nodeCount * globalRank);
-      k_contrib = 0.;
+    reused = moved <= PROJECTION_REUSE * jem::min(norm2(possA[endNodes_[1]] - possA[endNodes_[0]]),
+                                                  norm2(possB[endNodes_[1]] - possB[endNodes_[0]]));
+  }
 
-      contact_closed = computeSTS_(f_contrib, k_contrib, possA, possB, uA, uB);
+  if (reused)
+    poss_pair = point->second.poss; // measure the movement from the projected state
+  else
+    projected = findClosestPoints_(uA, uB, iterCount, possA, possB);
 
-      if (contact_closed && verbose_)
-        jem::System::debug(myName_) << "FOUND\n";
-      if (!contact_closed && verbose_)
-        jem::System::debug(myName_) << "not found\n";
+  u_pair[0] = projected ? uA : NAN;
+  u_pair[1] = projected ? uB : NAN;
 
-      if (!contact_closed)
-        continue;
+  if (verbose_)
+  {
+    jem::System::debug(myName_) << " > > Contact detection between elements " << elementA << " and " << elementB
+                                << " at local coordinates " << uA << " and " << uB;
+    if (reused)
+      jem::System::debug(myName_) << " (reused projection)";
+    else
+      jem::System::debug(myName_) << " after " << iterCount << " projection iterations"
+                                  << (projected ? "" : " (not converged)");
+    jem::System::debug(myName_) << "\n     ==} ";
+  }
 
-      dofsAB[SliceFromTo(0 * globalRank, 1 * globalRank)] = dofsA[0];
-      dofsAB[SliceFromTo(1 * globalRank, 2 * globalRank)] = dofsA[1];
-      dofsAB[SliceFromTo(2 * globalRank, 3 * globalRank)] = dofsB[0];
-      dofsAB[SliceFromTo(3 * globalRank, 4 * globalRank)] = dofsB[1];
-    }
-    else if (!shape_->containsLocalPoint(Vector({uA})) && shape_->containsLocalPoint(Vector({uB})))
-    {
-      idx_t iNodeA;
+  // without closest points only the end nodes are checked (last branch)
+  const bool insideA = projected && containsLocalPoint(uA);
+  const bool insideB = projected && containsLocalPoint(uB);
 
-      if (verbose_)
-        jem::System::debug(myName_) << "NTS contact ";
-      // LATER higher order elements
-      dofsAB.resize(globalRank * 3);
+  contact_closed = false;
 
-      f_contrib.resize((nodeCount + 1) * globalRank);
-      f_contrib = 0.;
-      k_contrib.resize((nodeCount + 1) * globalRank, (nodeCount + 1) * globalRank);
-      k_contrib = 0.;
+  if (insideA && insideB)
+  {
+    if (verbose_)
+      jem::System::debug(myName_) << "STS contact ";
+    useContribs(stsDofCount);
 
-      if (uA < -1.)
-      {
-        iNodeA = 0;
-      }
-      else // uA > 1.
-      {
-        iNodeA = 1;
-      }
+    contact_closed = computeSTS_(f_contrib, k_contrib, possA, possB, uA, uB, penetration);
 
-      uB = getClosestPoint_(possB[iNodeA], possA);
-      if (!(shape_->containsLocalPoint(Vector({uB}))))
-      {
-        if (verbose_)
-          jem::System::debug(myName_) << "not found (node not closest in segement)\n";
-        continue;
-      }
+    if (contact_closed && verbose_)
+      jem::System::debug(myName_) << "FOUND\n";
+    if (!contact_closed && verbose_)
+      jem::System::debug(myName_) << "not found\n";
 
-      contact_closed = computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB);
+    if (!contact_closed)
+      return 0;
 
-      if (contact_closed && verbose_)
-        jem::System::debug(myName_) << "FOUND between node " << nodesA[iNodeA] << " and element " << elementsB[iContact] << "\n";
-      if (!contact_closed && verbose_)
-        jem::System::debug(myName_) << "not found between node " << nodesA[iNodeA] << " and element " << elementsB[iContact] << "\n ";
+    addPenetration(penaltySTS_);
 
-      if (!contact_closed)
-        continue;
+    for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+    {
+      dofsAB[SliceFromTo(iNode * globalRank, (iNode + 1) * globalRank)] = dofsA[iNode];
+      dofsAB[SliceFromTo((nodeCount + iNode) * globalRank, (nodeCount + iNode + 1) * globalRank)] = dofsB[iNode];
+    }
+  }
+  else if (!insideA && insideB)
+  {
+    idx_t iNodeA;
+
+    if (verbose_)
+      jem::System::debug(myName_) << "NTS contact ";
+    useContribs(ntsDofCount);
 
-      dofsAB[SliceFromTo(0 * globalRank, 1 * globalRank)] = dofsA[iNodeA];
-      dofsAB[SliceFromTo(1 * globalRank, 2 * globalRank)] = dofsB[0];
-      dofsAB[SliceFromTo(2 * globalRank, 3 * globalRank)] = dofsB[1];
+    if (uA < -1.)
+    {
+      iNodeA = endNodes_[0];
     }
-    else if (!shape_->containsLocalPoint(Vector({uB})) && shape_->containsLocalPoint(Vector({uA})))
+    else // uA > 1.
     {
-      idx_t iNodeB;
+      iNodeA = endNodes_[1];
+    }
 
+    if (!getClosestPoint_(uB, possA[iNodeA], possB) || !(containsLocalPoint(uB)))
+    {
       if (verbose_)
-        jem::System::debug(myName_) << "NTS contact ";
-      dofsAB.resize(globalRank * 3);
+        jem::System::debug(myName_) << "not found (node not closest in segement)\n";
+      return 0;
+    }
 
-      f_contrib.resize((nodeCount + 1) * globalRank);
-      f_contrib = 0.;
-      k_contrib.resize((nodeCount + 1) * globalRank, (nodeCount + 1) * globalRank);
-      k_contrib = 0.;
+    contact_closed = computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB, penetration);
 
-      if (uB < -1.)
-      {
-        iNodeB = 0;
-      }
-      else // uB > 1.
-      {
-        iNodeB = 1;
-      }
+    if (contact_closed && verbose_)
+      jem::System::debug(myName_) << "FOUND between node " << nodesA[iNodeA] << " and element " << elementB << "\n";
+    if (!contact_closed && verbose_)
+      jem::System::debug(myName_) << "not found between node " << nodesA[iNodeA] << " and element " << elementB << "\n ";
 
-      uA = getClosestPoint_(possB[iNodeB], possA);
-      if (!(shape_->containsLocalPoint(Vector({uA}))))
-      {
-        if (verbose_)
-          jem::System::debug(myName_) << "not found (node not closest in segement)\n";
-        continue;
-      }
+    if (!contact_closed)
+      return 0;
 
-      contact_closed = computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA);
+    addPenetration(penaltyNTS_);
 
-      if (contact_closed && verbose_)
-        jem::System::debug(myName_) << "FOUND between node " << nodesB[iNodeB] << " and element " << elementsA[iContact] << "\n";
-      if (!contact_closed && verbose_)
-        jem::System::debug(myName_) << "not found between node " << nodesB[iNodeB] << " and element " << elementsA[iContact] << "\n";
+    dofsAB[SliceTo(globalRank)] = dofsA[iNodeA];
+    for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+      dofsAB[SliceFromTo((iNode + 1) * globalRank, (iNode + 2) * globalRank)] = dofsB[iNode];
+  }
+  else if (!insideB && insideA)
+  {
+    idx_t iNodeB;
 
-      if (!contact_closed)
-        continue;
+    if (verbose_)
+      jem::System::debug(myName_) << "NTS contact ";
+    useContribs(ntsDofCount);
 
-      dofsAB[SliceFromTo(0 * globalRank, 1 * globalRank)] = dofsB[iNodeB];
-      dofsAB[SliceFromTo(1 * globalRank, 2 * globalRank)] = dofsA[0];
-      dofsAB[SliceFromTo(2 * globalRank, 3 * globalRank)] = dofsA[1];
+    if (uB < -1.)
+    {
+      iNodeB = endNodes_[0];
+    }
+    else // uB > 1.
+    {
+      iNodeB = endNodes_[1];
     }
-    else // !shape_->containsLocalPoint(Vector({uA})) && !shape_->containsLocalPoint(Vector({uB}))
+
+    if (!getClosestPoint_(uA, possB[iNodeB], possA) || !(containsLocalPoint(uA)))
     {
       if (verbose_)
-        jem::System::debug(myName_) << "(speculative) NTS contact ";
-      // LATER higher order elements
-      dofsAB.resize(globalRank * 4);
+        jem::System::debug(myName_) << "not found (node not closest in segement)\n";
+      return 0;
+    }
 
-      f_contrib.resize(2 * nodeCount * globalRank);
-      f_contrib = 0.;
-      k_contrib.resize(2 * nodeCount * globalRank, 2 * nodeCount * globalRank);
-      k_contrib = 0.;
+    contact_closed = computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA, penetration);
 
-      Vector f_contribLocal((nodeCount + 1) * globalRank);
-      Matrix k_contribLocal((nodeCount + 1) * globalRank, (nodeCount + 1) * globalRank);
+    if (contact_closed && verbose_)
+      jem::System::debug(myName_) << "FOUND between node " << nodesB[iNodeB] << " and element " << elementA << "\n";
+    if (!contact_closed && verbose_)
+      jem::System::debug(myName_) << "not found between node " << nodesB[iNodeB] << " and element " << elementA << "\n";
 
-      // check both ends of A against B
-      for (idx_t iNodeA : {0, 1})
-      {
-        uB = getClosestPoint_(possA[iNodeA], possB);
-        if (!(shape_->containsLocalPoint(Vector({uB}))))
-          continue;
+    if (!contact_closed)
+      return 0;
 
-        f_contribLocal = 0.;
-        k_contribLocal = 0.;
+    addPenetration(penaltyNTS_);
 
-        if (computeNTS_(f_contribLocal, k_contribLocal, possA[iNodeA], possB, uB))
-        {
-          if (verbose_)
-            jem::System::debug(myName_)
-                << "FOUND between node " << nodesA[iNodeA] << " and element " << elementsB[iContact] << "; ";
+    dofsAB[SliceTo(globalRank)] = dofsB[iNodeB];
+    for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+      dofsAB[SliceFromTo((iNode + 1) * globalRank, (iNode + 2) * globalRank)] = dofsA[iNode];
+  }
+  else // !insideA && !insideB
+  {
+    if (verbose_)
+      jem::System::debug(myName_) << "(speculative) NTS contact ";
+    useContribs(stsDofCount);
 
-          f_contrib[SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)] += f_contribLocal[SliceTo(globalRank)];
-          f_contrib[SliceFromTo(2 * globalRank, 4 * globalRank)] += f_contribLocal[SliceFrom(globalRank)];
+    Vector f_contribLocal = work.f_local;
+    Matrix k_contribLocal = work.k_local;
 
-          k_contrib(SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank), SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceTo(globalRank));
-          k_contrib(SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank), SliceFromTo(2 * globalRank, 4 * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceFrom(globalRank));
-          k_contrib(SliceFromTo(2 * globalRank, 4 * globalRank), SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceTo(globalRank));
-          k_contrib(SliceFromTo(2 * globalRank, 4 * globalRank), SliceFromTo(2 * globalRank, 4 * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceFrom(globalRank));
+    // check both ends of A against B
+    for (idx_t iNodeA : endNodes_)
+    {
+      if (!getClosestPoint_(uB, possA[iNodeA], possB) || !(containsLocalPoint(uB)))
+        continue;
 
-          contact_closed = true;
-        }
-      }
+      f_contribLocal = 0.;
+      k_contribLocal = 0.;
 
-      // check both ends of B against A
-      for (idx_t iNodeB : {0, 1})
+      if (computeNTS_(f_contribLocal, k_contribLocal, possA[iNodeA], possB, uB, penetration))
       {
-        uA = getClosestPoint_(possB[iNodeB], possA);
-        if (!(shape_->containsLocalPoint(Vector({uA}))))
-          continue;
+        if (verbose_)
+          jem::System::debug(myName_)
+              << "FOUND between node " << nodesA[iNodeA] << " and element " << elementB << "; ";
+
+        f_contrib[SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)] += f_contribLocal[SliceTo(globalRank)];
+        f_contrib[SliceFrom(nodeCount * globalRank)] += f_contribLocal[SliceFrom(globalRank)];
 
-        f_contribLocal = 0.;
-        k_contribLocal = 0.;
+        k_contrib(SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank), SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceTo(globalRank));
+        k_contrib(SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank), SliceFrom(nodeCount * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceFrom(globalRank));
+        k_contrib(SliceFrom(nodeCount * globalRank), SliceFromTo(iNodeA * globalRank, (iNodeA + 1) * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceTo(globalRank));
+        k_contrib(SliceFrom(nodeCount * globalRank), SliceFrom(nodeCount * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceFrom(globalRank));
 
-        if (computeNTS_(f_contribLocal, k_contribLocal, possB[iNodeB], possA, uA))
-        {
-          if (verbose_)
-            jem::System::debug(myName_) << "FOUND between node " << nodesB[iNodeB] << " and element " << elementsA[iContact] << "; ";
+        contact_closed = true;
+        addPenetration(penaltyNTS_);
+      }
+    }
 
-          f_contrib[SliceFromTo(0 * globalRank, 2 * globalRank)] += f_contribLocal[SliceFrom(globalRank)];
-          f_contrib[SliceFromTo((2 + iNodeB) * globalRank, (3 + iNodeB) * globalRank)] += f_contribLocal[SliceTo(globalRank)];
+    // check both ends of B against A
+    for (idx_t iNodeB : endNodes_)
+    {
+      if (!getClosestPoint_(uA, possB[iNodeB], possA) || !(containsLocalPoint(uA)))
+        continue;
 
-          k_contrib(SliceFromTo(0 * globalRank, 2 * globalRank), SliceFromTo(0 * globalRank, 2 * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceFrom(globalRank));
-          k_contrib(SliceFromTo(0 * globalRank, 2 * globalRank), SliceFromTo((2 + iNodeB) * globalRank, (3 + iNodeB) * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceTo(globalRank));
-          k_contrib(SliceFromTo((2 + iNodeB) * globalRank, (3 + iNodeB) * globalRank), SliceFromTo(0 * globalRank, 2 * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceFrom(globalRank));
-          k_contrib(SliceFromTo((2 + iNodeB) * globalRank, (3 + iNodeB) * globalRank), SliceFromTo((2 + iNodeB) * globalRank, (3 + iNodeB) * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceTo(globalRank));
+      f_contribLocal = 0.;
+      k_contribLocal = 0.;
+
+      if (computeNTS_(f_contribLocal, k_contribLocal, possB[iNodeB], possA, uA, penetration))
+      {
+        if (verbose_)
+          jem::System::debug(myName_) << "FOUND between node " << nodesB[iNodeB] << " and element " << elementA << "; ";
 
-          contact_closed = true;
-        }
+        f_contrib[SliceTo(nodeCount * globalRank)] += f_contribLocal[SliceFrom(globalRank)];
+        f_contrib[SliceFromTo((nodeCount + iNodeB) * globalRank, (nodeCount + iNodeB + 1) * globalRank)] += f_contribLocal[SliceTo(globalRank)];
+
+        k_contrib(SliceTo(nodeCount * globalRank), SliceTo(nodeCount * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceFrom(globalRank));
+        k_contrib(SliceTo(nodeCount * globalRank), SliceFromTo((nodeCount + iNodeB) * globalRank, (nodeCount + iNodeB + 1) * globalRank)) += k_contribLocal(SliceFrom(globalRank), SliceTo(globalRank));
+        k_contrib(SliceFromTo((nodeCount + iNodeB) * globalRank, (nodeCount + iNodeB + 1) * globalRank), SliceTo(nodeCount * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceFrom(globalRank));
+        k_contrib(SliceFromTo((nodeCount + iNodeB) * globalRank, (nodeCount + iNodeB + 1) * globalRank), SliceFromTo((nodeCount + iNodeB) * globalRank, (nodeCount + iNodeB + 1) * globalRank)) += k_contribLocal(SliceTo(globalRank), SliceTo(globalRank));
+
+        contact_closed = true;
+        addPenetration(penaltyNTS_);
       }
+    }
 
-      if (contact_closed && verbose_)
-        jem::System::debug(myName_) << "\n";
+    if (contact_closed && verbose_)
+      jem::System::debug(myName_) << "\n";
 
-      if (!contact_closed && verbose_)
-        jem::System::debug(myName_) << "not found\n";
+    if (!contact_closed && verbose_)
+      jem::System::debug(myName_) << "not found\n";
 
-      if (!contact_closed)
-        continue;
+    if (!contact_closed)
+      return 0;
 
-      dofsAB[SliceFromTo(0 * globalRank, 1 * globalRank)] = dofsA[0];
-      dofsAB[SliceFromTo(1 * globalRank, 2 * globalRank)] = dofsA[1];
-      dofsAB[SliceFromTo(2 * globalRank, 3 * globalRank)] = dofsB[0];
-      dofsAB[SliceFromTo(3 * globalRank, 4 * globalRank)] = dofsB[1];
+    for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+    {
+      dofsAB[SliceFromTo(iNode * globalRank, (iNode + 1) * globalRank)] = dofsA[iNode];
+      dofsAB[SliceFromTo((nodeCount + iNode) * globalRank, (nodeCount + iNode + 1) * globalRank)] = dofsB[iNode];
     }
+  }
 
-    if (verbose_)
-      jem::System::debug(myName_) << "       contact force " << f_contrib << " applied \n";
+  if (verbose_)
+    jem::System::debug(myName_) << "       contact force " << f_contrib << " applied \n";
 
-    fint[dofsAB] += f_contrib;
-    mbld.addBlock(dofsAB, dofsAB, k_contrib);
+  return dofCount;
+}
 
-    contactsA_.pushBack(elementsA[iContact]);
-    contactsB_.pushBack(elementsB[iContact]);
-  } // end of loop over contacts
+//-----------------------------------------------------------------------
+//   initPairWork_
+//-----------------------------------------------------------------------
+void RodContactModel::initPairWork_()
+{
+  const idx_t nodeCount = shape_->nodeCount();
+  const idx_t globalRank = shape_->globalRank();
+  const idx_t ntsDofCount = (nodeCount + 1) * globalRank;
 
-  if (verbose_)
-    jem::System::debug(myName_) << " > > > > Done computing contacts\n";
+  // parallelFor runs on at most threadCount_ threads
+  pairWork_.resize(jem::max(threadCount_, (idx_t)1));
+
+  for (idx_t it = 0; it < pairWork_.size(); it++)
+  {
+    PairWork_ &work = pairWork_[it];
+
+    work.nodesA.resize(nodeCount);
+    work.nodesB.resize(nodeCount);
+    work.possA.resize(globalRank, nodeCount);
+    work.possB.resize(globalRank, nodeCount);
+    work.dofsA.resize(globalRank, nodeCount);
+    work.dofsB.resize(globalRank, nodeCount);
+    work.f_local.resize(ntsDofCount);
+    work.k_local.resize(ntsDofCount, ntsDofCount);
+    work.point.resize(1);
+    work.transTypes.resize(globalRank);
+    work.transTypes = jem::iarray(globalRank);
+  }
 }
 
 //-----------------------------------------------------------------------
@@ -765,22 +1111,29 @@ void RodContactModel::computeBlacklist_
   IdxMatrix dofsA(globalRank, nodeCount);
   IdxMatrix dofsB(globalRank, nodeCount);
 
-  double uA = 0; // local coordinates
-  double uB = 0;
+  double uA; // local coordinates
+  double uB;
 
   Vector f_contrib(0);
   Matrix k_contrib(0, 0);
 
+  bool projected;
+  idx_t iterCount;
   bool contact_closed;
+  double penetration;
 
   for (idx_t iContact = 0; iContact < elementsA.size(); iContact++)
   {
+    // every pair starts from the element centers
+    uA = 0.;
+    uB = 0.;
+
     allElems_.getElemNodes(nodesA, elementsA[iContact]);
     allNodes_.getSomeCoords(possA, nodesA);
     allElems_.getElemNodes(nodesB, elementsB[iContact]);
     allNodes_.getSomeCoords(possB, nodesB);
 
-    if (nodesA[0] == nodesB[0] || nodesA[0] == nodesB[1] || nodesA[1] == nodesB[0] || nodesA[1] == nodesB[1]) // LATER higher order elements
+    if (shareNodes_(nodesA, nodesB))
     {
       if (verbose_)
         jem::System::debug(myName_) << " > > Skipping contact between elements " << elementsA[iContact] << " and " << elementsB[iContact] << " (same nodes)\n";
@@ -795,17 +1148,23 @@ void RodContactModel::computeBlacklist_
       possB[iNode] += disp[dofsB[iNode]];
     }
 
-    findClosestPoints_(uA, uB, possA, possB);
+    projected = findClosestPoints_(uA, uB, iterCount, possA, possB);
 
     if (verbose_)
       jem::System::debug(myName_) << " > > Contact detection between elements " << elementsA[iContact] << " and " << elementsB[iContact]
-                                  << " at local coordinates " << uA << " and " << uB << " ==} ";
+                                  << " at local coordinates " << uA << " and " << uB
+                                  << " after " << iterCount << " projection iterations"
+                                  << (projected ? "" : " (not converged)") << " ==} ";
+
+    // without closest points only the end nodes are checked (last branch)
+    const bool insideA = projected && shape_->containsLocalPoint(Vector({uA}));
+    const bool insideB = projected && shape_->containsLocalPoint(Vector({uB}));
 
     contact_closed = false;
 
-    if (shape_->containsLocalPoint(Vector({uA})) && shape_->containsLocalPoint(Vector({uB})))
+    if (insideA && insideB)
     {
-      contact_closed = computeSTS_(f_contrib, k_contrib, possA, possB, uA, uB);
+      contact_closed = computeSTS_(f_contrib, k_contrib, possA, possB, uA, uB, penetration);
 
       if (contact_closed && verbose_)
         jem::System::debug(myName_) << "STS CONTACT\n";
@@ -818,28 +1177,27 @@ void RodContactModel::computeBlacklist_
         blacklistB.pushBack(elementsB[iContact]);
       }
     }
-    else if (!shape_->containsLocalPoint(Vector({uA})) && shape_->containsLocalPoint(Vector({uB})))
+    else if (!insideA && insideB)
     {
       idx_t iNodeA;
 
       if (uA < -1.)
       {
-        iNodeA = 0;
+        iNodeA = endNodes_[0];
       }
       else // uA > 1.
       {
-        iNodeA = 1;
+        iNodeA = endNodes_[1];
       }
 
-      uB = getClosestPoint_(possB[iNodeA], possA);
-      if (!(shape_->containsLocalPoint(Vector({uB}))))
+      if (!getClosestPoint_(uB, possA[iNodeA], possB) || !(shape_->containsLocalPoint(Vector({uB}))))
       {
         if (verbose_)
           jem::System::debug(myName_) << "NO contact\n";
         continue;
       }
 
-      contact_closed = computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB);
+      contact_closed = computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB, penetration);
 
       if (contact_closed && verbose_)
         jem::System::debug(myName_) << "NTS CONTACT\n";
@@ -852,28 +1210,27 @@ void RodContactModel::computeBlacklist_
         blacklistB.pushBack(elementsB[iContact]);
       }
     }
-    else if (!shape_->containsLocalPoint(Vector({uB})) && shape_->containsLocalPoint(Vector({uA})))
+    else if (!insideB && insideA)
     {
       idx_t iNodeB;
       
       if (uB < -1.)
       {
-        iNodeB = 0;
+        iNodeB = endNodes_[0];
       }
       else // uB > 1.
       {
-        iNodeB = 1;
+        iNodeB = endNodes_[1];
       }
 
-      uA = getClosestPoint_(possB[iNodeB], possA);
-      if (!(shape_->containsLocalPoint(Vector({uA}))))
+      if (!getClosestPoint_(uA, possB[iNodeB], possA) || !(shape_->containsLocalPoint(Vector({uA}))))
       {
         if (verbose_)
           jem::System::debug(myName_) << "NO contact\n";
         continue;
       }
 
-      contact_closed = computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA);
+      contact_closed = computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA, penetration);
 
       if (contact_closed && verbose_)
         jem::System::debug(myName_) << "NTS CONTACT\n";
@@ -886,26 +1243,24 @@ void RodContactModel::computeBlacklist_
         blacklistB.pushBack(elementsB[iContact]);
       }
     }
-    else // !shape_->containsLocalPoint(Vector({uA})) && !shape_->containsLocalPoint(Vector({uB}))
+    else // !insideA && !insideB
     {
       // check both ends of A against B
-      for (idx_t iNodeA : {0, 1})
+      for (idx_t iNodeA : endNodes_)
       {
-        uB = getClosestPoint_(possA[iNodeA], possB);
-        if (!(shape_->containsLocalPoint(Vector({uB}))))
+        if (!getClosestPoint_(uB, possA[iNodeA], possB) || !(shape_->containsLocalPoint(Vector({uB}))))
           continue;
 
-        contact_closed |= computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB);
+        contact_closed |= computeNTS_(f_contrib, k_contrib, possA[iNodeA], possB, uB, penetration);
       }
 
       // check both ends of B against A
-      for (idx_t iNodeB : {0, 1})
+      for (idx_t iNodeB : endNodes_)
       {
-        uA = getClosestPoint_(possB[iNodeB], possA);
-        if (!(shape_->containsLocalPoint(Vector({uA}))))
+        if (!getClosestPoint_(uA, possB[iNodeB], possA) || !(shape_->containsLocalPoint(Vector({uA}))))
           continue;
 
-        contact_closed |= computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA);
+        contact_closed |= computeNTS_(f_contrib, k_contrib, possB[iNodeB], possA, uA, penetration);
       }
 
       if (contact_closed && verbose_)
@@ -921,17 +1276,17 @@ void RodContactModel::computeBlacklist_
     }
   } // end of loop over contacts
 
-  blacklistA_.resize(blacklistA.size());
-  blacklistB_.resize(blacklistB.size());
+  blacklist_.clear();
+  blacklist_.reserve(blacklistA.size());
 
-  blacklistA_ = blacklistA.toArray();
-  blacklistB_ = blacklistB.toArray();
+  for (idx_t i = 0; i < blacklistA.size(); i++)
+    blacklist_.insert(blacklistKey_(blacklistA[i], blacklistB[i]));
 
   if (verbose_)
   {
     jem::System::debug(myName_) << " > > > > Done computing blacklist\n";
-    jem::System::debug(myName_) << " > > blacklisted elements A: " << blacklistA_ << "\n";
-    jem::System::debug(myName_) << " > > blacklisted elements B: " << blacklistB_ << "\n";
+    jem::System::debug(myName_) << " > > blacklisted elements A: " << blacklistA.toArray() << "\n";
+    jem::System::debug(myName_) << " > > blacklisted elements B: " << blacklistB.toArray() << "\n";
   }
 }
 
@@ -944,46 +1299,97 @@ bool RodContactModel::filterBlacklist_
      const idx_t elementB) const
 
 {
-  return (jem::testany(blacklistA_ == elementA && blacklistB_ == elementB) || jem::testany(blacklistA_ == elementB && blacklistB_ == elementA));
+  return blacklist_.count(blacklistKey_(elementA, elementB)) > 0;
 }
 
 //-----------------------------------------------------------------------
 //   findClosestPoints
 //-----------------------------------------------------------------------
-void RodContactModel::findClosestPoints_
+bool RodContactModel::findClosestPoints_
 
     (double &uA,
      double &uB,
+     idx_t &iterCount,
      const Matrix &possA,
      const Matrix &possB) const
 {
-  Vector bA(shape_->globalRank());
-  Vector bB(shape_->globalRank());
-  Vector tA(shape_->globalRank());
-  Vector tB(shape_->globalRank());
+  const idx_t nodeCount = shape_->nodeCount();
+  const idx_t globalRank = shape_->globalRank();
 
-  switch (shape_->nodeCount())
+  iterCount = 0;
+
+  Vector bA(globalRank);
+  Vector bB(globalRank);
+  Vector tA(globalRank);
+  Vector tB(globalRank);
+
+  switch (nodeCount)
   {
   case 2:
+  {
     // Wriggers/Zavarise 1997
     bA = possA(ALL, 1) + possA(ALL, 0);
     bB = possB(ALL, 1) + possB(ALL, 0);
     tA = possA(ALL, 1) - possA(ALL, 0);
     tB = possB(ALL, 1) - possB(ALL, 0);
 
-    uA = -1. * dotProduct(bB - bA, tB * dotProduct(tB, tA) - tA * dotProduct(tB, tB)) / (dotProduct(tB, tB) * dotProduct(tA, tA) - dotProduct(tB, tA) * dotProduct(tB, tA));
-    uB = +1. * dotProduct(bB - bA, tA * dotProduct(tB, tA) - tB * dotProduct(tA, tA)) / (dotProduct(tB, tB) * dotProduct(tA, tA) - dotProduct(tB, tA) * dotProduct(tB, tA));
-    break;
+    const double det = dotProduct(tB, tB) * dotProduct(tA, tA) - dotProduct(tB, tA) * dotProduct(tB, tA);
 
-  case 3:
-    /* LATER quadratic Elements */
-    throw jem::Error(JEM_FUNC, "Quadratic Elements not implemented yet");
-    break;
+    // parallel segments have no unique closest points
+    if (det <= PROJECTION_TOL * dotProduct(tB, tB) * dotProduct(tA, tA))
+      return false;
 
+    uA = -1. * dotProduct(bB - bA, tB * dotProduct(tB, tA) - tA * dotProduct(tB, tB)) / det;
+    uB = +1. * dotProduct(bB - bA, tA * dotProduct(tB, tA) - tB * dotProduct(tA, tA)) / det;
+    return true;
+  }
+
+  case 3:
   case 4:
-    /* LATER cubic Elements */
-    throw jem::Error(JEM_FUNC, "Cubic Elements not implemented yet");
-    break;
+  {
+    // Newton iteration on the squared distance of the curved centerlines
+    Vector N_A(nodeCount);
+    Vector N_B(nodeCount);
+    Vector dN_A(nodeCount);
+    Vector dN_B(nodeCount);
+    Vector ddN_A(nodeCount);
+    Vector ddN_B(nodeCount);
+    Vector r(globalRank);
+    Vector dpA(globalRank);
+    Vector dpB(globalRank);
+
+    for (idx_t iter = 0; iter < MAX_PROJECTION_ITER; iter++)
+    {
+      iterCount = iter + 1;
+
+      shape_->evalShapeGradGrads(N_A, dN_A, ddN_A, Vector({uA}));
+      shape_->evalShapeGradGrads(N_B, dN_B, ddN_B, Vector({uB}));
+
+      r = matmul(possB, N_B) - matmul(possA, N_A);
+      dpA = matmul(possA, dN_A);
+      dpB = matmul(possB, dN_B);
+
+      const double gA = -1. * dotProduct(r, dpA);
+      const double gB = dotProduct(r, dpB);
+      const double hAA = dotProduct(dpA, dpA) - dotProduct(r, matmul(possA, ddN_A));
+      const double hAB = -1. * dotProduct(dpA, dpB);
+      const double hBB = dotProduct(dpB, dpB) + dotProduct(r, matmul(possB, ddN_B));
+      const double det = hAA * hBB - hAB * hAB;
+
+      if (det <= 0. || jem::isTiny(det))
+        return false; // parallel or strongly curved segments
+
+      const double duA = -1. * (hBB * gA - hAB * gB) / det;
+      const double duB = -1. * (hAA * gB - hAB * gA) / det;
+
+      uA = jem::max(-MAX_PROJECTION_COORD, jem::min(MAX_PROJECTION_COORD, uA + duA));
+      uB = jem::max(-MAX_PROJECTION_COORD, jem::min(MAX_PROJECTION_COORD, uB + duB));
+
+      if (std::abs(duA) + std::abs(duB) < PROJECTION_TOL)
+        return true;
+    }
+    return false;
+  }
 
   default:
     throw jem::Error(JEM_FUNC, "Invalid number of nodes in the element");
@@ -993,32 +1399,64 @@ void RodContactModel::findClosestPoints_
 //-----------------------------------------------------------------------
 //   getClosestPoint_
 //-----------------------------------------------------------------------
-double RodContactModel::getClosestPoint_
+bool RodContactModel::getClosestPoint_
 
-    (const Vector &posS,
+    (double &uM,
+     const Vector &posS,
      const Matrix &possM) const
 {
-  Vector bM(shape_->globalRank());
-  Vector tM(shape_->globalRank());
+  const idx_t nodeCount = shape_->nodeCount();
+  const idx_t globalRank = shape_->globalRank();
 
-  switch (shape_->nodeCount())
+  Vector bM(globalRank);
+  Vector tM(globalRank);
+
+  // projection onto the chord between the end nodes
+  bM = possM[endNodes_[1]] + possM[endNodes_[0]];
+  tM = possM[endNodes_[1]] - possM[endNodes_[0]];
+
+  // collapsed element
+  if (jem::isTiny(dotProduct(tM, tM)))
+    return false;
+
+  uM = (2 * dotProduct(posS, tM) - dotProduct(tM, bM)) / dotProduct(tM, tM);
+
+  switch (nodeCount)
   {
   case 2:
-    bM = possM(ALL, 1) + possM(ALL, 0);
-    tM = possM(ALL, 1) - possM(ALL, 0);
-
-    return (2 * dotProduct(posS, tM) - dotProduct(tM, bM)) / dotProduct(tM, tM);
-    break;
+    return true;
 
   case 3:
-    /* LATER quadratic Elements */
-    throw jem::Error(JEM_FUNC, "Quadratic Elements not implemented yet");
-    break;
-
   case 4:
-    /* LATER cubic Elements */
-    throw jem::Error(JEM_FUNC, "Cubic Elements not implemented yet");
-    break;
+  {
+    // Newton iteration on the curved centerline, starting from the chord
+    Vector N(nodeCount);
+    Vector dN(nodeCount);
+    Vector ddN(nodeCount);
+    Vector r(globalRank);
+    Vector dp(globalRank);
+
+    for (idx_t iter = 0; iter < MAX_PROJECTION_ITER; iter++)
+    {
+      shape_->evalShapeGradGrads(N, dN, ddN, Vector({uM}));
+
+      r = matmul(possM, N) - posS;
+      dp = matmul(possM, dN);
+
+      const double h = dotProduct(dp, dp) + dotProduct(r, matmul(possM, ddN));
+
+      if (h <= 0. || jem::isTiny(h))
+        return false;
+
+      const double du = -1. * dotProduct(r, dp) / h;
+
+      uM = jem::max(-MAX_PROJECTION_COORD, jem::min(MAX_PROJECTION_COORD, uM + du));
+
+      if (std::abs(du) < PROJECTION_TOL)
+        return true;
+    }
+    return false;
+  }
 
   default:
     throw jem::Error(JEM_FUNC, "Invalid number of nodes in the element");
@@ -1035,7 +1473,8 @@ bool RodContactModel::computeSTS_
      const Matrix &possA,
      const Matrix &possB,
      const double uA,
-     const double uB) const
+     const double uB,
+     double &penetration) const
 {
   const idx_t nodeCount = shape_->nodeCount();
   const idx_t globalRank = shape_->globalRank();
@@ -1054,6 +1493,8 @@ bool RodContactModel::computeSTS_
   if (distance > 2. * radius_)
     return false;
 
+  penetration = 2. * radius_ - distance;
+
   if (f_contrib.size() == 0)
     return true;
 
@@ -1083,7 +1524,6 @@ bool RodContactModel::computeSTS_
   Matrix C(2, 2 * globalRank);
   Matrix D(2, 2 * nodeCount * globalRank);
   Matrix E(2 * nodeCount * globalRank, 2 * nodeCount * globalRank);
-  // Matrix F(2 * nodeCount * globalRank, 2 * nodeCount * globalRank);
   Matrix G(2 * nodeCount * globalRank, 2 * nodeCount * globalRank);
 
   contact_normal = (pB - pA) / distance;
@@ -1116,7 +1556,7 @@ bool RodContactModel::computeSTS_
   A(0, 0) = -1. * dotProduct(dpA, dpA) + dotProduct(pB - pA, ddpA);
   A(0, 1) = dotProduct(dpB, dpA);
   A(1, 0) = -1. * dotProduct(dpA, dpB);
-  A(1, 1) = dotProduct(dpB, dpB) - dotProduct(pB - pA, ddpB);
+  A(1, 1) = dotProduct(dpB, dpB) + dotProduct(pB - pA, ddpB);
 
   B(0, SliceTo(globalRank)) = dpA;
   B(0, SliceFrom(globalRank)) = -1. * dpA;
@@ -1129,24 +1569,38 @@ bool RodContactModel::computeSTS_
 
   D = matmul(jem::numeric::inverse(A), Matrix(matmul(B, H_hat) + matmul(C, dH_hat)));
 
-  E(SliceTo(globalRank * nodeCount), ALL) = -1. * matmul(matmul(dH_A.transpose(), contact_normal), D(0, ALL));
-  E(SliceFrom(globalRank * nodeCount), ALL) = matmul(matmul(dH_B.transpose(), contact_normal), D(1, ALL));
+  f_contrib += penaltySTS_ * (distance - 2. * radius_) * matmul(H_tilde.transpose(), contact_normal);
+  k_contrib += penaltySTS_ * matmul(matmul(H_tilde.transpose(), matmul(contact_normal, contact_normal)), H_tilde);
 
-  if (norm2(ddpA) + norm2(ddpB) > 1e-12)
+  if (nodeCount == 2)
   {
-    // LATER implement 'F' for higher order elements
-    throw jem::Error(JEM_FUNC, "higher order elements not implemented yet");
+    E(SliceTo(globalRank * nodeCount), ALL) = -1. * matmul(matmul(dH_A.transpose(), contact_normal), D(0, ALL));
+    E(SliceFrom(globalRank * nodeCount), ALL) = matmul(matmul(dH_B.transpose(), contact_normal), D(1, ALL));
+
+    G = matmul(
+            matmul(Matrix(H_tilde.transpose() + matmul(D(1, ALL), dpB) - matmul(D(0, ALL), dpA)),
+                   Matrix(eye(globalRank) - matmul(contact_normal, contact_normal))),
+            Matrix(H_tilde + matmul(D(1, ALL), dpB).transpose() - matmul(D(0, ALL), dpA).transpose())) /
+        distance;
+
+    k_contrib += penaltySTS_ * (distance - 2. * radius_) * (E + E.transpose() + G);
   }
+  else
+  {
+    // second derivative of the distance for curved segments, the closest
+    // points follow the nodes with D
+    Vector cA(2 * nodeCount * globalRank);
+    Vector cB(2 * nodeCount * globalRank);
 
-  G = matmul(
-          matmul(Matrix(H_tilde.transpose() + matmul(D(1, ALL), dpB) - matmul(D(0, ALL), dpA)),
-                 Matrix(eye(globalRank) - matmul(contact_normal, contact_normal))),
-          Matrix(H_tilde + matmul(D(1, ALL), dpB).transpose() - matmul(D(0, ALL), dpA).transpose())) /
-      distance;
+    cA = -1. * matmul(dH_hat(SliceTo(globalRank), ALL).transpose(), contact_normal) - matmul(H_tilde.transpose(), dpA) / distance;
+    cB = matmul(dH_hat(SliceFrom(globalRank), ALL).transpose(), contact_normal) + matmul(H_tilde.transpose(), dpB) / distance;
 
-  f_contrib += penaltySTS_ * (distance - 2. * radius_) * matmul(H_tilde.transpose(), contact_normal);
-  k_contrib += penaltySTS_ * matmul(matmul(H_tilde.transpose(), matmul(contact_normal, contact_normal)), H_tilde);
-  k_contrib += penaltySTS_ * (distance - 2. * radius_) * (E + E.transpose() + G);
+    G = matmul(matmul(H_tilde.transpose(), Matrix(eye(globalRank) - matmul(contact_normal, contact_normal))), H_tilde) / distance;
+    G += matmul(cA, D(0, ALL)) + matmul(cB, D(1, ALL));
+
+    // symmetric up to round-off
+    k_contrib += penaltySTS_ * (distance - 2. * radius_) * 0.5 * (G + G.transpose());
+  }
 
   return true;
 }
@@ -1160,7 +1614,8 @@ bool RodContactModel::computeNTS_
      Matrix &k_contrib,
      const Vector &possS,
      const Matrix &possM,
-     const double uM) const
+     const double uM,
+     double &penetration) const
 {
   const idx_t globalRank = shape_->globalRank();
 
@@ -1176,33 +1631,85 @@ bool RodContactModel::computeNTS_
   if (distance > 2. * radius_)
     return false;
 
+  penetration = 2. * radius_ - distance;
+
   if (f_contrib.size() == 0)
     return true;
 
-  // Wriggers/Simo 1985
-  Vector n(globalRank);
-  Vector t(globalRank);
-  n = (possS - pM) / distance;
-  t = (possM[1] - possM[0]) / norm2(possM[1] - possM[0]);
+  if (shape_->nodeCount() == 2)
+  {
+    // Wriggers/Simo 1985
+    Vector n(globalRank);
+    Vector t(globalRank);
+    n = (possS - pM) / distance;
+    t = (possM[1] - possM[0]) / norm2(possM[1] - possM[0]);
+
+    Vector Ns(3 * globalRank);
+    Vector Ts(3 * globalRank);
+    Vector N(3 * globalRank);
+
+    Ns[SliceTo(globalRank)] = n;
+    Ts[SliceTo(globalRank)] = t;
+    N[SliceTo(globalRank)] = 0.;
+
+    Ns[SliceFromTo(globalRank, 2 * globalRank)] = -.5 * (1. - uM) * n; // change since uM is in [-1,1] and not [0,1]
+    Ts[SliceFromTo(globalRank, 2 * globalRank)] = -.5 * (1. - uM) * t;
+    N[SliceFromTo(globalRank, 2 * globalRank)] = -1. * n;
+
+    Ns[SliceFrom(2 * globalRank)] = -.5 * (1. + uM) * n;
+    Ts[SliceFrom(2 * globalRank)] = -.5 * (1. + uM) * t;
+    N[SliceFrom(2 * globalRank)] = n;
+
+    f_contrib += penaltyNTS_ * (distance - 2. * radius_) * Ns;
+    k_contrib += penaltyNTS_ * (matmul(Ns, Ns) - (distance - 2. * radius_) / norm2(possM[1] - possM[0]) * (matmul(N, Ts) + matmul(Ts, N) + (distance - 2. * radius_) / norm2(possM[1] - possM[0]) * matmul(N, N)));
+
+    return true;
+  }
+
+  // curved main segment, the closest point follows the nodes with
+  // duM = a * du / m
+  const idx_t nodeCount = shape_->nodeCount();
+  const idx_t dofCount = (nodeCount + 1) * globalRank;
+
+  Vector N(nodeCount); // shape functions
+  Vector dN(nodeCount);
+  Vector ddN(nodeCount);
+  Vector n(globalRank); // contact normal
+  Vector r(globalRank);
+  Vector dp(globalRank);
+  Vector Ns(dofCount);
+  Vector a(dofCount);
+  Matrix H(globalRank, dofCount);  // variation of the gap vector
+  Matrix dH(globalRank, dofCount); // variation of the main tangent
+  Matrix G(dofCount, dofCount);
+
+  shape_->evalShapeGradGrads(N, dN, ddN, Vector({uM}));
+
+  r = possS - pM;
+  n = r / distance;
+  dp = matmul(possM, dN);
+
+  H = 0.;
+  dH = 0.;
+  H(ALL, SliceTo(globalRank)) = eye(globalRank);
 
-  Vector Ns(3 * globalRank);
-  Vector Ts(3 * globalRank);
-  Vector N(3 * globalRank);
+  for (idx_t iNode = 0; iNode < nodeCount; iNode++)
+  {
+    H(ALL, SliceFromTo((iNode + 1) * globalRank, (iNode + 2) * globalRank)) = -1. * N[iNode] * eye(globalRank);
+    dH(ALL, SliceFromTo((iNode + 1) * globalRank, (iNode + 2) * globalRank)) = dN[iNode] * eye(globalRank);
+  }
 
-  Ns[SliceTo(globalRank)] = n;
-  Ts[SliceTo(globalRank)] = t;
-  N[SliceTo(globalRank)] = 0.;
+  Ns = matmul(H.transpose(), n);
+  a = matmul(H.transpose(), dp) + matmul(dH.transpose(), r);
 
-  Ns[SliceFromTo(globalRank, 2 * globalRank)] = -.5 * (1. - uM) * n; // change since uM is in [-1,1] and not [0,1]
-  Ts[SliceFromTo(globalRank, 2 * globalRank)] = -.5 * (1. - uM) * t;
-  N[SliceFromTo(globalRank, 2 * globalRank)] = -1. * n;
+  const double m = dotProduct(dp, dp) - dotProduct(r, matmul(possM, ddN));
 
-  Ns[SliceFrom(2 * globalRank)] = -.5 * (1. + uM) * n;
-  Ts[SliceFrom(2 * globalRank)] = -.5 * (1. + uM) * t;
-  N[SliceFrom(2 * globalRank)] = n;
+  G = matmul(matmul(H.transpose(), Matrix(eye(globalRank) - matmul(n, n))), H);
+  if (m > 0. && !jem::isTiny(m))
+    G -= matmul(a, a) / m;
 
   f_contrib += penaltyNTS_ * (distance - 2. * radius_) * Ns;
-  k_contrib += penaltyNTS_ * (matmul(Ns, Ns) - (distance - 2. * radius_) / norm2(possM[1] - possM[0]) * (matmul(N, Ts) + matmul(Ts, N) + (distance - 2. * radius_) / norm2(possM[1] - possM[0]) * matmul(N, N)));
+  k_contrib += penaltyNTS_ * (matmul(Ns, Ns) + (distance - 2. * radius_) / distance * G);
 
   return true;
 }
@@ -15,6 +15,8 @@
 #include "misc/Line3D.h"
 #include "models/LatticeModel.h"
 #include "models/SpecialCosseratRodModel.h"
+#include "utils/BoxTree.h"
+#include "utils/parallel.h"
 #include <jem/base/Array.h>
 #include <jem/base/Error.h>
 #include <jem/base/System.h>
@@ -25,6 +27,7 @@
 #include <jive/app/Names.h>
 #include <jive/fem/ElementSet.h>
 #include <jive/implict/Names.h>
+#include <jive/implict/SolverInfo.h>
 #include <jive/model/Actions.h>
 #include <jive/model/Model.h>
 #include <jive/model/ModelFactory.h>
@@ -34,6 +37,10 @@
 #include <jive/util/FuncUtils.h>
 #include <jive/util/XTable.h>
 
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
 using jem::ALL;
 using jem::newInstance;
 using jem::Ref;
@@ -48,6 +55,7 @@ using jive::algebra::MatrixBuilder;
 using jive::algebra::NullMatrixBuilder;
 using jive::fem::ElementSet;
 using jive::fem::NodeSet;
+using jive::implict::SolverInfo;
 using jive::model::ActionParams;
 using jive::model::Actions;
 using jive::model::Model;
@@ -72,10 +80,17 @@ using jive::util::XTable;
  *
  * Features:
  * - Segment-to-segment (STS) and node-to-segment (NTS) contact formulations
+ * - Linear, quadratic and cubic elements with projections onto the curved centerline
  * - Automatic contact pair detection and filtering
+ * - Bounding volume hierarchy over the rod elements
+ * - Candidate lists with a skin distance, rebuilt only after large motions
+ * - Optional self-contact between non-adjacent elements of one rod
  * - Blacklist system to exclude initial contacts
  * - Configurable penalty parameters for different contact types
  * - Rod radius specification for contact detection
+ * - Narrow phase evaluated concurrently with an ordered scatter
+ * - Penalty energy per node and in total, step rejection on deep penetration
+ * - Contact forces and energies of the converged state kept for table output
  * - Verbose output options for debugging
  */
 class RodContactModel : public Model
@@ -86,12 +101,24 @@ public:
 
   /// @name Property identifiers
   /// @{
-  static const char *TYPE_NAME;        ///< Model type name
-  static const char *PENALTY_PROP;     ///< General penalty property
-  static const char *PENALTY_STS_PROP; ///< Segment-to-segment penalty property
-  static const char *PENALTY_NTS_PROP; ///< Node-to-segment penalty property
-  static const char *RADIUS_PROP;      ///< Rod radius property
-  static const char *VERBOSE_PROP;     ///< Verbose output property
+  static const char *TYPE_NAME;            ///< Model type name
+  static const char *PENALTY_PROP;         ///< General penalty property
+  static const char *PENALTY_STS_PROP;     ///< Segment-to-segment penalty property
+  static const char *PENALTY_NTS_PROP;     ///< Node-to-segment penalty property
+  static const char *RADIUS_PROP;          ///< Rod radius property
+  static const char *VERBOSE_PROP;         ///< Verbose output property
+  static const char *SKIN_PROP;            ///< Candidate list skin distance property
+  static const char *THREAD_COUNT_PROP;    ///< Narrow phase thread count property
+  static const char *SELF_CONTACT_PROP;    ///< Self-contact property
+  static const char *MAX_PENETRATION_PROP; ///< Accepted penetration property
+  /// @}
+
+  /// @name Projection constants
+  /// @{
+  static const idx_t MAX_PROJECTION_ITER;   ///< Newton iterations of curved projections
+  static const double PROJECTION_TOL;       ///< Local coordinate tolerance of curved projections
+  static const double MAX_PROJECTION_COORD; ///< Bound of projected local coordinates
+  static const double PROJECTION_REUSE;     ///< Node movement per element length up to which projections are reused
   /// @}
 
   /// @brief Constructor
@@ -129,32 +156,31 @@ public:
 
 protected:
   /// @brief Find pairs of contacts
+  /// @details Returns the cached candidate pairs. They are rebuilt first if
+  /// a rod node has moved more than half the skin distance since the last
+  /// build.
   /// @param elementsA Element IDs of one side of the contact
   /// @param elementsB Element IDs of the other side
   /// @param disp Displacement vector of all elements
   virtual void findContacts_(IdxVector &elementsA,
                              IdxVector &elementsB,
-                             const Vector &disp) const;
+                             const Vector &disp);
 
-  /// @brief Find beams of possible contact pairs
-  /// @param beamsA Indices of the beams in contact
-  /// @param beamsB Indices of corresponding beams
+  /// @brief Rebuild the candidate pairs of contacts
+  /// @details Queries the element bounding volume hierarchy, which is refit
+  /// to the current displacements beforehand
   /// @param disp Displacement vector of all elements
-  virtual void findPossibleBeams_(IdxVector &beamsA,
-                                  IdxVector &beamsB,
-                                  const Vector &disp) const;
-
-  /// @brief Get the contacting point between two beams in possible contact
-  /// @param elemsA Element ID of one side of the contact
-  /// @param elemsB Corresponding element ID on the other side
-  /// @param beamA Possible beam on side A
-  /// @param beamB Possible beam on side B
+  virtual void buildCandidates_(const Vector &disp);
+
+  /// @brief Get the bounding boxes of all rod elements
+  /// @details The boxes enclose the displaced element nodes, inflated by the
+  /// overshoot of curved centerlines beyond the nodes, the rod radius and
+  /// half the skin distance, and are stored in the layout of
+  /// jive_helpers::BoxTree
+  /// @param boxes Element boxes (2*rank x rod element count)
   /// @param disp Displacement vector of all elements
-  virtual void findPossibleElements_(IdxVector &elemsA,
-                                     IdxVector &elemsB,
-                                     const idx_t &beamA,
-                                     const idx_t &beamB,
-                                     const Vector &disp) const;
+  virtual void getElemBoxes_(const Matrix &boxes,
+                             const Vector &disp) const;
 
   /// @brief Compute the effects of the contact
   /// @param mbld Stiffness matrix builder
@@ -168,6 +194,49 @@ protected:
                                 const IdxVector &elementsB,
                                 const Vector &disp);
 
+  /// @brief Evaluate the contacts in the current configuration
+  /// @details Updates the contact lists, the penalty energies and the
+  /// deepest penetration without assembling anything
+  /// @param disp Displacement vector of all elements
+  virtual void updateContactState_(const Vector &disp);
+
+  /// @brief Check whether the last evaluation was made at the given state
+  /// @details Set by every evaluation of all candidates (GET_INT_VECTOR,
+  /// GET_MATRIX0 or updateContactState_) and reset on ADVANCE, CANCEL and
+  /// COMMIT. The state is compared as well, since explicit integrators
+  /// update it after the force evaluation.
+  /// @param disp Displacement vector of all elements
+  /// @return Whether the contact forces and energies can be reused
+  bool isEvaluatedAt_(const Vector &disp) const;
+
+  /// @brief Compute the force and stiffness contributions of one contact pair
+  /// @details Only reads shared data, so pairs can be evaluated concurrently.
+  /// The closest points stored for the pair are used as the starting guess
+  /// of the projection. They are reused without projecting while no node
+  /// moved more than PROJECTION_REUSE times the shorter element length.
+  /// @param f_pair Force contribution (at least 2*nodeCount*rank entries)
+  /// @param k_pair Stiffness contribution (at least as large as f_pair)
+  /// @param dofs_pair DOF indices of the contributions (as large as f_pair)
+  /// @param u_pair Local coordinates of the closest points (2, output, NaN if the projection did not converge)
+  /// @param poss_pair Node positions of A and B of the projection (rank x 2*nodeCount, output)
+  /// @param energy_pair Penalty energy of the pair (output)
+  /// @param penetration_pair Deepest overlap of the rods (output)
+  /// @param elementA Element ID A
+  /// @param elementB Element ID B
+  /// @param disp Displacement vector of all elements
+  /// @return number of DOFs of the contributions (0 if the contact is open,
+  /// -1 if the pair is filtered before the projection)
+  virtual idx_t computePair_(const Vector &f_pair,
+                             const Matrix &k_pair,
+                             const IdxVector &dofs_pair,
+                             const Vector &u_pair,
+                             const Matrix &poss_pair,
+                             double &energy_pair,
+                             double &penetration_pair,
+                             const idx_t elementA,
+                             const idx_t elementB,
+                             const Vector &disp) const;
+
   /// @brief Build the list of nodes initially in contact
   /// @param elementsA Element IDs A
   /// @param elementsB Element IDs B
@@ -176,6 +245,26 @@ protected:
                                  const IdxVector &elementsB,
                                  const Vector &disp);
 
+  /// @brief Size the scratch arrays of the pair evaluation
+  void initPairWork_();
+
+  /// @return the scratch arrays of the calling thread
+  inline PairWork_ &getPairWork_() const;
+
+  /// @brief Check whether two elements share a node
+  /// @param nodesA Nodes of element A
+  /// @param nodesB Nodes of element B
+  /// @return true if any node appears in both elements
+  static inline bool shareNodes_(const IdxVector &nodesA,
+                                 const IdxVector &nodesB)
+  {
+    for (idx_t iA = 0; iA < nodesA.size(); iA++)
+      for (idx_t iB = 0; iB < nodesB.size(); iB++)
+        if (nodesA[iA] == nodesB[iB])
+          return true;
+    return false;
+  }
+
   /// @brief Check whether a contact is on the blacklist
   /// @param elementsA Element ID A
   /// @param elementsB Element ID B
@@ -183,22 +272,56 @@ protected:
   virtual bool filterBlacklist_(const idx_t elementsA,
                                 const idx_t elementsB) const;
 
+  /// @brief Get the blacklist key of an element pair
+  /// @param elementA Element ID A
+  /// @param elementB Element ID B
+  /// @return key that does not depend on the order of the elements
+  /// (unique for element IDs below 2^32)
+  static inline std::uint64_t blacklistKey_(const idx_t elementA,
+                                            const idx_t elementB)
+  {
+    const std::uint64_t lo = (std::uint64_t)jem::min(elementA, elementB);
+    const std::uint64_t hi = (std::uint64_t)jem::max(elementA, elementB);
+    return (hi << 32) | lo;
+  }
+
+  /// @brief Get the key of an ordered element pair
+  /// @param elementA Element ID A
+  /// @param elementB Element ID B
+  /// @return key of the pair (unique for element IDs below 2^32)
+  static inline std::uint64_t contactKey_(const idx_t elementA,
+                                          const idx_t elementB)
+  {
+    return ((std::uint64_t)elementA << 32) | (std::uint64_t)elementB;
+  }
+
   /// @brief Find the local coordinates of the closest points on two beams
-  /// @param uA Local coordinate Beam A
-  /// @param uB Local coordinate Beam B
+  /// @details Curved (3- and 4-node) elements are projected with a Newton
+  /// iteration starting from the given coordinates; the closed-form
+  /// projection of linear elements ignores them
+  /// @param uA Local coordinate Beam A (starting guess on input)
+  /// @param uB Local coordinate Beam B (starting guess on input)
+  /// @param iterCount Number of Newton iterations (0 for linear elements, output)
   /// @param possA Positions Beam A
   /// @param possB Positions Beam B
-  virtual void findClosestPoints_(double &uA,
+  /// @return false for (nearly) parallel beams or a diverged Newton
+  /// iteration, in which case the coordinates are not usable
+  virtual bool findClosestPoints_(double &uA,
                                   double &uB,
+                                  idx_t &iterCount,
                                   const Matrix &possA,
                                   const Matrix &possB) const;
 
   /// @brief Get the closest coordinate on the main element to the secondary point
+  /// @details Curved elements are projected with a Newton iteration starting
+  /// from the projection onto the chord between the end nodes
+  /// @param uM Coordinate on the main element (output)
   /// @param posS Secondary point
   /// @param possM Main element positions
-  /// @return Coordinate on the main element
-  virtual double getClosestPoint_(const Vector &posS,
-                                  const Matrix &possM) const;
+  /// @return false for a collapsed element or a diverged Newton iteration
+  virtual bool getClosestPoint_(double &uM,
+                                const Vector &posS,
+                                const Matrix &possM) const;
 
   /// @brief Compute the force and stiffness contributions of a segment-to-segment contact
   /// @param f_contrib Force contribution
@@ -207,6 +330,7 @@ protected:
   /// @param possB Positions of Beam B
   /// @param uA Local coordinate Beam A
   /// @param uB Local coordinate Beam B
+  /// @param penetration Overlap of the rods if contact is active (output)
   /// @return true if contact is active
   /// @see [Wriggers, Zavarise (1999)](https://doi.org/10.1002/(SICI)1099-0887(199706)13:6%3C429::AID-CNM70%3E3.0.CO;2-X)
   virtual bool computeSTS_(Vector &f_contrib,
@@ -214,7 +338,8 @@ protected:
                            const Matrix &possA,
                            const Matrix &possB,
                            const double uA,
-                           const double uB) const;
+                           const double uB,
+                           double &penetration) const;
 
   /// @brief Compute the force and stiffness contributions of a node-to-segment contact
   /// @param f_contrib Force contribution
@@ -222,13 +347,15 @@ protected:
   /// @param possS Position of the secondary node
   /// @param possM Positions of the main beam
   /// @param uM Local coordinate of the main beam
+  /// @param penetration Overlap of the rods if contact is active (output)
   /// @return true if contact is active
   /// @see [Wriggers, Simo (1985)](https://doi.org/10.1002/cnm.1630010503)
   virtual bool computeNTS_(Vector &f_contrib,
                            Matrix &k_contrib,
                            const Vector &possS,
                            const Matrix &possM,
-                           const double uM) const;
+                           const double uM,
+                           double &penetration) const;
 
 private:
   Assignable<NodeSet> allNodes_;            ///< All nodes in the model
@@ -236,17 +363,80 @@ private:
   Array<Assignable<ElementGroup>> rodList_; ///< List of rod element groups
   Ref<DofSpace> dofs_;                      ///< DOF space
   Ref<Line3D> shape_;                       ///< Line shape functions
+  IdxVector endNodes_;                      ///< Local nodes at u = -1 and u = 1
+  double hullOvershoot_;                    ///< Bound of the centerline beyond the node hull per node spread
+
+  IdxVector rodElems_;         ///< Element IDs of all rods
+  IdxVector rodElemRods_;      ///< Rod index of every entry in rodElems_
+  Array<IdxVector> rodNodes_;  ///< Sorted node indices of every rod
+  Matrix elemBoxes_;           ///< Current element boxes
+  jive_helpers::BoxTree tree_; ///< Bounding volume hierarchy of rodElems_
+
+  IdxVector candidatesA_; ///< Candidate elements A
+  IdxVector candidatesB_; ///< Candidate elements B
+  IdxMatrix rodDofs_;     ///< Translational DOFs of all rod nodes
+  Matrix candidateDisp_;  ///< Rod node displacements at the last candidate build
+
+  std::unordered_set<std::uint64_t> blacklist_; ///< Blacklisted element pairs (see blacklistKey_)
+
+  /// @brief Closest points of a contact pair at its last projection
+  struct ContactPoint_
+  {
+    double uA;   ///< Local coordinate on element A
+    double uB;   ///< Local coordinate on element B
+    Matrix poss; ///< Node positions of A and B used for the projection
+  };
+
+  /// Closest points of the candidate pairs (see contactKey_)
+  std::unordered_map<std::uint64_t, ContactPoint_> contactPoints_;
 
-  IdxVector blacklistA_; ///< Blacklisted elements A
-  IdxVector blacklistB_; ///< Blacklisted elements B
+  /// @brief Scratch arrays of the pair evaluation (one set per thread)
+  struct PairWork_
+  {
+    IdxVector nodesA;      ///< Nodes of element A
+    IdxVector nodesB;      ///< Nodes of element B
+    Matrix possA;          ///< Node positions of element A
+    Matrix possB;          ///< Node positions of element B
+    IdxMatrix dofsA;       ///< Translational DOFs of element A
+    IdxMatrix dofsB;       ///< Translational DOFs of element B
+    Vector f_local;        ///< Force of a single node-to-segment contact
+    Matrix k_local;        ///< Stiffness of a single node-to-segment contact
+    Vector point;          ///< Local coordinate passed to the shape
+    IdxVector transTypes;  ///< Translational DOF types
+  };
+
+  mutable jem::Array<PairWork_> pairWork_; ///< Pair scratch arrays (see PairWork_)
 
   ArrayBuffer<idx_t> contactsA_; ///< Contact elements A
   ArrayBuffer<idx_t> contactsB_; ///< Contact elements B
 
   Ref<Function> updCond_; ///< Update condition function
 
-  double penaltySTS_; ///< Segment-to-segment penalty parameter
-  double penaltyNTS_; ///< Node-to-segment penalty parameter
-  double radius_;     ///< Rod radius
-  bool verbose_;      ///< Verbose output flag
+  double penaltySTS_;             ///< Segment-to-segment penalty parameter
+  double penaltyNTS_;             ///< Node-to-segment penalty parameter
+  double radius_;                 ///< Rod radius
+  double skin_;                   ///< Skin distance of the candidate lists
+  idx_t threadCount_;             ///< Number of threads for the narrow phase
+  bool selfContact_;              ///< Whether non-adjacent elements of one rod can touch
+  double maxPenetrationFraction_; ///< Accepted penetration per rod radius (0 to disable)
+  bool verbose_;                  ///< Verbose output flag
+
+  double contactEnergy_;  ///< Penalty energy of the last evaluation
+  double maxPenetration_; ///< Deepest penetration of the last evaluation
+  bool evaluated_;        ///< Whether the last evaluation covered all candidates
+  Vector evalDisp_;       ///< State of the last evaluation of all candidates
+  Vector nodeEnergy_;     ///< Penalty energy per node of the last evaluation
+  Vector contactForce_;   ///< Contact forces of the last evaluation (all DOFs)
+
+  Vector committedForce_;  ///< Contact forces of the last converged state (all DOFs)
+  Vector committedEnergy_; ///< Penalty energy per node of the last converged state
 };
+
+//-----------------------------------------------------------------------
+//   getPairWork_
+//-----------------------------------------------------------------------
+
+inline RodContactModel::PairWork_ &RodContactModel::getPairWork_() const
+{
+  return pairWork_[jive_helpers::threadIndex()];
+}
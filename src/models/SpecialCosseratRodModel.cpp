@@ -10,6 +10,7 @@
 #include "models/SpecialCosseratRodModel.h"
 
 #include <jem/base/ClassTemplate.h>
+#include <jem/util/Event.h>
 #include <math.h>
 
 using jem::newInstance;
@@ -35,11 +36,45 @@ const char *SpecialCosseratRodModel::GIVEN_NODES = "given_dir_nodes";
 const char *SpecialCosseratRodModel::GIVEN_DIRS = "given_dir_dirs";
 const char *SpecialCosseratRodModel::LUMPED_MASS = "lumpedMass";
 const char *SpecialCosseratRodModel::HINGES = "hinges";
+const char *SpecialCosseratRodModel::THREAD_COUNT = "threadCount";
+const char *SpecialCosseratRodModel::SHEAR_SHAPE = "shearShape";
+const char *SpecialCosseratRodModel::MATRIX_FREE = "matrixFree";
 const idx_t SpecialCosseratRodModel::TRANS_DOF_COUNT = 3;
 const idx_t SpecialCosseratRodModel::ROT_DOF_COUNT = 3;
 const Slice SpecialCosseratRodModel::TRANS_PART = jem::SliceFromTo(0, TRANS_DOF_COUNT);
 const Slice SpecialCosseratRodModel::ROT_PART = jem::SliceFromTo(TRANS_DOF_COUNT, TRANS_DOF_COUNT + ROT_DOF_COUNT);
 
+//-----------------------------------------------------------------------
+//   class TangentOperator_
+//-----------------------------------------------------------------------
+
+// Applies the tangent stiffness of the linearization point stored during
+// the last GET_MATRIX0 action without assembling it.
+
+class SpecialCosseratRodModel::TangentOperator_ : public AbstractMatrix
+{
+public:
+  explicit TangentOperator_(const SpecialCosseratRodModel *model)
+      : model_(model)
+  {
+  }
+
+  virtual Shape shape() const override
+  {
+    const idx_t dofCount = model_->dofs_->dofCount();
+
+    return Shape(dofCount, dofCount);
+  }
+
+  virtual void matmul(const Vector &lhs, const Vector &rhs) const override
+  {
+    model_->applyTangent_(lhs, rhs);
+  }
+
+private:
+  const SpecialCosseratRodModel *model_; // owns this operator
+};
+
 //-----------------------------------------------------------------------
 //   constructor
 //-----------------------------------------------------------------------
@@ -103,6 +138,17 @@ SpecialCosseratRodModel::SpecialCosseratRodModel
 
   // Initialize the internal shape.
   myProps.makeProps("stiffShape").set("numPoints", allElems_.getElemNodeCount(rodElems_.getIndex(0)));
+  // selective integration: the shear/axial terms get their own (reduced)
+  // scheme, the curvature terms are fully integrated by default
+  if (myProps.contains(SHEAR_SHAPE))
+  {
+    if (!myProps.getProps("stiffShape").contains("intScheme"))
+      myProps.makeProps("stiffShape").set("intScheme", "Gauss" + String(allElems_.getElemNodeCount(rodElems_.getIndex(0))));
+    myProps.makeProps(SHEAR_SHAPE).set("numPoints", allElems_.getElemNodeCount(rodElems_.getIndex(0)));
+    shapeR_ = newInstance<Line3D>(SHEAR_SHAPE, myConf, myProps);
+  }
+  else
+    shapeR_ = nullptr;
   shapeK_ = newInstance<Line3D>("stiffShape", myConf, myProps);
   myProps.makeProps("massShape").set("numPoints", allElems_.getElemNodeCount(rodElems_.getIndex(0)));
   myProps.makeProps("massShape").set("intScheme", "Gauss" + String(allElems_.getElemNodeCount(rodElems_.getIndex(0))));
@@ -111,6 +157,8 @@ SpecialCosseratRodModel::SpecialCosseratRodModel
   // Check whether the mesh is valid.
   rodElems_.checkElements(getContext(), shapeK_->nodeCount());
   rodElems_.checkElements(getContext(), shapeM_->nodeCount());
+  if (shapeR_)
+    rodElems_.checkElements(getContext(), shapeR_->nodeCount());
 
   // Define the DOFs.
   Ref<XDofSpace> dofs = XDofSpace::get(allNodes_.getData(), globdat);
@@ -139,8 +187,15 @@ SpecialCosseratRodModel::SpecialCosseratRodModel
   // get the nonmutable DOF-Space into the class member
   dofs_ = dofs;
 
+  // rebuild the index tables when the DofSpace changes
+  dofTablesValid_ = false;
+  rotCacheValid_ = false;
+  outputValid_ = false;
+  jem::util::connect(dofs_->newSizeEvent, this, &Self::invalidateDofTables_);
+  jem::util::connect(dofs_->newOrderEvent, this, &Self::invalidateDofTables_);
+
   // get the material
-  props.set(joinNames(myName_, "material.ipCount"), shapeK_->ipointCount());
+  props.set(joinNames(myName_, "material.ipCount"), ipointCount_());
   props.set(joinNames(myName_, "material.elemCount"), rodElems_.size());
   material_ = MaterialFactory::newInstance(joinNames(myName_, "material"), conf, props, globdat);
 
@@ -149,6 +204,28 @@ SpecialCosseratRodModel::SpecialCosseratRodModel
   myProps.find(symOnly_, SYMMETRIC_ONLY);
   myConf.set(SYMMETRIC_ONLY, symOnly_);
 
+  // apply the tangent without assembling it (Krylov solvers only)
+  matrixFree_ = false;
+  myProps.find(matrixFree_, MATRIX_FREE);
+  myConf.set(MATRIX_FREE, matrixFree_);
+  if (matrixFree_)
+    tangent_ = newInstance<TangentOperator_>(this);
+  else
+    tangent_ = nullptr;
+
+  // get the number of threads for the element loops (0 = all available)
+  threadCount_ = 1;
+  myProps.find(threadCount_, THREAD_COUNT, 0, 1024);
+  if (threadCount_ == 0)
+    threadCount_ = jive_helpers::maxThreadCount();
+  if (threadCount_ > 1 && !material_->isThreadSafe())
+  {
+    jem::System::warn() << myName_ << " : material " << material_->getName()
+                        << " is not thread safe, using a single thread\n";
+    threadCount_ = 1;
+  }
+  myConf.set(THREAD_COUNT, threadCount_);
+
   // Get the material parameters.
   if (myProps.find(materialYDir_, MATERIAL_Y_DIR))
   {
@@ -209,6 +286,9 @@ bool SpecialCosseratRodModel::takeAction
 
   if (action == Actions::INIT)
   {
+    initDofTables_();
+    initRefGeometry_();
+    initElemWork_();
     initRotation_();
     initStrain_();
     // TEST_CONTEXT(LambdaN_)
@@ -218,6 +298,17 @@ bool SpecialCosseratRodModel::takeAction
     return true;
   }
 
+  // the DofSpace changed since the tables were built
+  if (!dofTablesValid_)
+    initDofTables_();
+
+  // the solvers change the state between force evaluations and after the
+  // last one, only the committed rotations are kept for tables and masses
+  if (action == Actions::GET_MATRIX0 || action == Actions::GET_INT_VECTOR ||
+      action == SolverNames::GET_TANGENT_OPERATOR || action == Actions::COMMIT ||
+      action == Actions::ADVANCE || action == Actions::CANCEL)
+    rotCacheValid_ = false;
+
   if (action == Actions::GET_TABLE)
   {
     Ref<XTable> table;
@@ -234,6 +325,7 @@ bool SpecialCosseratRodModel::takeAction
     {
       Vector disp;
       StateVector::get(disp, dofs_, globdat);
+      updateNodeRotations_(disp);
 
       if (name == "strain")
         getStrainTable_(*table, weights, disp);
@@ -253,6 +345,7 @@ bool SpecialCosseratRodModel::takeAction
     {
       Vector disp;
       StateVector::get(disp, dofs_, globdat);
+      updateNodeRotations_(disp);
 
       if (name == "potentialEnergy")
         getPotentialEnergy_(*table, weights, disp);
@@ -263,6 +356,13 @@ bool SpecialCosseratRodModel::takeAction
 
   if (action == Actions::GET_MATRIX0)
   {
+    // an empty stiffness would silently make the system singular
+    if (matrixFree_)
+      throw jem::IllegalInputException(
+          getContext(),
+          "the rod stiffness is not assembled with matrixFree = true, "
+          "use a matrix-free solver module");
+
     Ref<MatrixBuilder> mbld;
     Vector fint;
     Vector disp;
@@ -278,11 +378,13 @@ bool SpecialCosseratRodModel::takeAction
 
     // Get the current displacements.
     StateVector::get(disp, dofs_, globdat);
+    updateNodeRotations_(disp);
     // TEST_CONTEXT( disp )
 
     // Assemble the global stiffness matrix together with
     // the internal vector.
     assemble_(*mbld, fint, disp, loadCase);
+    outputValid_ = false;
 
     // // DEBUGGING
     // IdxVector dofList(fint.size());
@@ -304,6 +406,41 @@ bool SpecialCosseratRodModel::takeAction
     return true;
   }
 
+  if (action == SolverNames::GET_TANGENT_OPERATOR)
+  {
+    Vector fint;
+    Vector disp;
+    String loadCase = "";
+
+    if (!matrixFree_)
+      return false;
+
+    // linearize at the current state together with the internal vector
+    if (params.find(fint, ActionParams::INT_VECTOR))
+    {
+      globdat.find(loadCase, jive::app::PropNames::LOAD_CASE);
+
+      StateVector::get(disp, dofs_, globdat);
+      updateNodeRotations_(disp);
+
+      assembleTangentState_(fint, disp, loadCase);
+      outputValid_ = false;
+    }
+
+    params.set(SolverNames::TANGENT_OPERATOR, tangent_);
+    return true;
+  }
+
+  if (action == SolverNames::GET_STABLE_STEP_SIZE)
+  {
+    double dtime = jem::Float::MAX_VALUE;
+
+    params.find(dtime, SolverNames::STABLE_STEP_SIZE);
+    params.set(SolverNames::STABLE_STEP_SIZE, jem::min(dtime, getStableStep_()));
+
+    return true;
+  }
+
   if (action == Actions::GET_MATRIX2)
   {
     Ref<MatrixBuilder> mbld;
@@ -311,6 +448,7 @@ bool SpecialCosseratRodModel::takeAction
 
     params.get(mbld, ActionParams::MATRIX2);
     StateVector::get(disp, dofs_, globdat);
+    updateNodeRotations_(disp);
 
     assembleM_(*mbld, disp);
 
@@ -343,10 +481,12 @@ bool SpecialCosseratRodModel::takeAction
 
     // Get the current displacements.
     StateVector::get(disp, dofs_, globdat);
+    updateNodeRotations_(disp);
 
     // Assemble the global stiffness matrix together with
     // the internal vector.
     assemble_(fint, disp, loadCase);
+    outputValid_ = false;
 
     if (params.find(mass, ActionParams::MATRIX2))
     {
@@ -367,6 +507,7 @@ bool SpecialCosseratRodModel::takeAction
   if (action == Actions::COMMIT)
   {
     material_->applyDeform();
+    outputValid_ = false;
 
     Properties vars = Globdat::getVariables(globdat);
     Vector disp;
@@ -378,6 +519,7 @@ bool SpecialCosseratRodModel::takeAction
     vars.find(E_diss, "dissipatedEnergy");
 
     StateVector::get(disp, dofs_, globdat);
+    updateNodeRotations_(disp);
     E_diss += getDissipatedEnergy_(disp);
     E_pot += getPotentialEnergy_(disp);
 
@@ -390,6 +532,7 @@ bool SpecialCosseratRodModel::takeAction
   if (action == Actions::CANCEL)
   {
     material_->rejectDeform();
+    outputValid_ = false;
     return true;
   }
 
@@ -431,20 +574,13 @@ void SpecialCosseratRodModel::getStrainTable_
      const bool mat_vals)
 {
   const idx_t elemCount = rodElems_.size();
-  const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t ipCount = shapeK_->ipointCount();
   String dofName = "";
 
   IdxVector icols(dofs_->typeCount());
-  IdxVector inodes(nodeCount);
 
-  Vector ipWeights(ipCount);
-  Matrix Lambda_r(TRANS_DOF_COUNT, TRANS_DOF_COUNT);
-  Matrix nodePhi_0(TRANS_DOF_COUNT, nodeCount);
-  Matrix nodeU(TRANS_DOF_COUNT, nodeCount);
-  Cubix nodeLambda(TRANS_DOF_COUNT, TRANS_DOF_COUNT, nodeCount);
-
-  Matrix strain(TRANS_DOF_COUNT + ROT_DOF_COUNT, ipCount);
+  updateOutput_(disp);
+  const Cubix strain = mat_vals ? outMatStrain_ : outStrain_;
 
   // add all the dofs to the Table
   for (idx_t idof = 0; idof < dofs_->typeCount(); idof++)
@@ -462,15 +598,10 @@ void SpecialCosseratRodModel::getStrainTable_
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
     idx_t ielem = rodElems_.getIndices()[ie];
-    allElems_.getElemNodes(inodes, ielem);
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStrains_(strain, ipWeights, nodePhi_0, nodeU, nodeLambda, ie,
-                !mat_vals);
 
     for (idx_t ip = 0; ip < ipCount; ip++)
     {
-      strain_table.addRowValues(ielem, icols, strain(ALL, ip));
+      strain_table.addRowValues(ielem, icols, strain(ALL, ip, ie));
       weights[ielem] += 1.;
     }
   }
@@ -485,20 +616,13 @@ void SpecialCosseratRodModel::getStressTable_
      const bool mat_vals)
 {
   const idx_t elemCount = rodElems_.size();
-  const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t ipCount = shapeK_->ipointCount();
   String dofName = "";
 
   IdxVector icols(dofs_->typeCount());
-  IdxVector inodes(nodeCount);
-
-  Vector ipWeights(ipCount);
-  Matrix Lambda_r(TRANS_DOF_COUNT, TRANS_DOF_COUNT);
-  Matrix nodePhi_0(TRANS_DOF_COUNT, nodeCount);
-  Matrix nodeU(TRANS_DOF_COUNT, nodeCount);
-  Cubix nodeLambda(TRANS_DOF_COUNT, TRANS_DOF_COUNT, nodeCount);
 
-  Matrix stress(TRANS_DOF_COUNT + ROT_DOF_COUNT, ipCount);
+  updateOutput_(disp);
+  const Cubix stress = mat_vals ? outMatStress_ : outStress_;
 
   // add all the dofs to the Table
   for (idx_t idof = 0; idof < dofs_->typeCount(); idof++)
@@ -516,15 +640,10 @@ void SpecialCosseratRodModel::getStressTable_
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
     idx_t ielem = rodElems_.getIndex(ie);
-    allElems_.getElemNodes(inodes, ielem);
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStresses_(stress, ipWeights, nodePhi_0, nodeU, nodeLambda, ie,
-                 !mat_vals);
 
     for (idx_t ip = 0; ip < ipCount; ip++)
     {
-      stress_table.addRowValues(ielem, icols, stress(ALL, ip));
+      stress_table.addRowValues(ielem, icols, stress(ALL, ip, ie));
       weights[ielem] += 1.;
     }
   }
@@ -537,15 +656,16 @@ void SpecialCosseratRodModel::initStrain_()
 {
   const idx_t rank = shapeK_->globalRank();
   const idx_t dofCount = dofs_->typeCount();
-  const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
   const idx_t elemCount = rodElems_.size();
   const idx_t nodeCount = shapeK_->nodeCount();
 
+  ElemWork_ &work = getElemWork_();
+
   // PER ELEMENT VALUES
   Vector weights(ipCount);
   IdxVector ins(nodeCount);
   IdxVector inodes(nodeCount);
-  Matrix coords(rank, nodeCount);
   // STRAINS
   Matrix strains(dofCount, ipCount);
   Matrix null_mat(rank, nodeCount);
@@ -556,18 +676,165 @@ void SpecialCosseratRodModel::initStrain_()
 
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    idx_t ielem = rodElems_.getIndex(ie);
-    allElems_.getElemNodes(ins, ielem);
-    allNodes_.getSomeCoords(coords, ins);
-    // TEST_CONTEXT(coords)
+    ins = elemNodes_[ie];
     inodes = rodNodes_[ins];
     // TEST_CONTEXT((Cubix(LambdaN_[inodes])))
-    getStrains_(strains, weights, coords, null_mat,
-                Cubix(LambdaN_[inodes]), ie, false);
+    getStrains_(strains, weights, refCoords_[ie], null_mat,
+                Cubix(LambdaN_[inodes]), ie, work, false);
     matStrain0_[ie] = strains;
   }
 }
 
+//-----------------------------------------------------------------------
+//   initDofTables_
+//-----------------------------------------------------------------------
+void SpecialCosseratRodModel::initDofTables_()
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t dofCount = dofs_->typeCount();
+  const IdxVector allnodes = rodElems_.getNodeIndices();
+
+  IdxVector inodes(nodeCount);
+  IdxVector idofs(dofCount);
+
+  elemNodes_.resize(nodeCount, elemCount);
+  elemDofs_.resize(nodeCount * dofCount, elemCount);
+  nodeDofs_.resize(dofCount, allnodes.size());
+  rotVecs_.resize(allnodes.size(), ROT_DOF_COUNT);
+  rotExp_.resize(allnodes.size(), ROT_DOF_COUNT * ROT_DOF_COUNT);
+
+  for (idx_t inode = 0; inode < allnodes.size(); inode++)
+  {
+    dofs_->getDofIndices(idofs, allnodes[inode], jtypes_);
+    nodeDofs_[inode] = idofs;
+  }
+
+  for (idx_t ie = 0; ie < elemCount; ie++)
+  {
+    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
+    elemNodes_[ie] = inodes;
+
+    for (idx_t inode = 0; inode < nodeCount; inode++)
+      elemDofs_(SliceFromTo(inode * dofCount, (inode + 1) * dofCount), ie) =
+          nodeDofs_[rodNodes_[inodes[inode]]];
+  }
+
+  dofTablesValid_ = true;
+}
+
+//-----------------------------------------------------------------------
+//   invalidateDofTables_
+//-----------------------------------------------------------------------
+void SpecialCosseratRodModel::invalidateDofTables_()
+{
+  dofTablesValid_ = false;
+  rotCacheValid_ = false;
+  outputValid_ = false;
+}
+
+//-----------------------------------------------------------------------
+//   initElemWork_
+//-----------------------------------------------------------------------
+void SpecialCosseratRodModel::initElemWork_()
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t fullCount = shapeK_->ipointCount();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t dofCount = dofs_->typeCount();
+  const idx_t rank = shapeK_->globalRank();
+  const idx_t psiCount = dofCount + TRANS_DOF_COUNT;
+
+  // parallelFor runs on at most threadCount_ threads
+  elemWork_.resize(jem::max(threadCount_, (idx_t)1));
+
+  for (idx_t it = 0; it < elemWork_.size(); it++)
+  {
+    ElemWork_ &work = elemWork_[it];
+
+    work.nodeU.resize(rank, nodeCount);
+    work.nodePhi_0.resize(rank, nodeCount);
+    work.nodeLambda.resize(rank, rank, nodeCount);
+    work.ipLambda.resize(rank, rank, ipCount);
+    work.strainLambda.resize(rank, rank, ipCount);
+    work.strainLambdaP.resize(rank, rank, ipCount);
+    work.matStrains.resize(dofCount, ipCount);
+    work.stress.resize(dofCount, ipCount);
+    work.weights.resize(ipCount);
+    work.XI.resize(dofCount, dofCount, nodeCount, ipCount);
+    work.XIK.resize(dofCount, dofCount, nodeCount, fullCount);
+    work.XIR.resize(dofCount, dofCount, nodeCount, ipCount - fullCount);
+    work.spatialC.resize(dofCount, dofCount);
+    work.geomStiff.resize(psiCount, psiCount, ipCount);
+    work.elemXI.resize(nodeCount * dofCount, dofCount);
+    work.elemX.resize(nodeCount * dofCount);
+    work.ipStrain.resize(dofCount);
+    work.ipStress.resize(dofCount);
+    work.psiX.resize(psiCount);
+    work.psiY.resize(psiCount);
+    work.B.resize(psiCount, psiCount);
+  }
+}
+
+//-----------------------------------------------------------------------
+//   initRefGeometry_
+//-----------------------------------------------------------------------
+void SpecialCosseratRodModel::initRefGeometry_()
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t rank = shapeK_->globalRank();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t fullCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
+  const idx_t dofCount = dofs_->typeCount();
+
+  Matrix coords(rank, nodeCount);
+  Vector weights(ipCount);
+  Quadix PSI(dofCount, dofCount + TRANS_DOF_COUNT, nodeCount, fullCount);
+  Quadix PSIR;
+
+  if (shapeR_)
+    PSIR.resize(dofCount, dofCount + TRANS_DOF_COUNT, nodeCount,
+                ipCount - fullCount);
+
+  refCoords_.resize(rank, nodeCount, elemCount);
+  refGrads_.resize(shapeK_->shapeFuncCount(), ipCount, elemCount);
+  refWeights_.resize(ipCount, elemCount);
+  refMassWeights_.resize(shapeM_->ipointCount(), elemCount);
+  refPsi_.resize(nodeCount * dofCount, dofCount + TRANS_DOF_COUNT, ipCount,
+                 elemCount);
+  ipShapes_.resize(nodeCount, ipCount);
+
+  ipShapes_(ALL, SliceTo(fullCount)) = shapeK_->getShapeFunctions();
+  if (shapeR_)
+    ipShapes_(ALL, SliceFrom(fullCount)) = shapeR_->getShapeFunctions();
+
+  // all of these only depend on the reference configuration
+  for (idx_t ie = 0; ie < elemCount; ie++)
+  {
+    allNodes_.getSomeCoords(coords, elemNodes_[ie]);
+    refCoords_[ie] = coords;
+
+    shapeK_->getShapeGradients(refGrads_[ie](ALL, SliceTo(fullCount)),
+                               weights[SliceTo(fullCount)], coords);
+    shapeK_->getPsi(PSI, weights[SliceTo(fullCount)], coords);
+    if (shapeR_)
+    {
+      shapeR_->getShapeGradients(refGrads_[ie](ALL, SliceFrom(fullCount)),
+                                 weights[SliceFrom(fullCount)], coords);
+      shapeR_->getPsi(PSIR, weights[SliceFrom(fullCount)], coords);
+    }
+    refWeights_[ie] = weights;
+    shapeM_->getIntegrationWeights(refMassWeights_[ie], coords);
+
+    for (idx_t ip = 0; ip < ipCount; ip++)
+      for (idx_t inode = 0; inode < nodeCount; inode++)
+        refPsi_[ie][ip](SliceFromTo(inode * dofCount, (inode + 1) * dofCount),
+                        ALL) = ip < fullCount ? PSI[ip][inode]
+                                              : PSIR[ip - fullCount][inode];
+  }
+}
+
 //-----------------------------------------------------------------------
 //   initRotation_
 //-----------------------------------------------------------------------
@@ -606,9 +873,7 @@ void SpecialCosseratRodModel::initRotation_()
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
     // REPORT(ie)
-    idx_t ielem = rodElems_.getIndex(ie);
-    allElems_.getElemNodes(ins, ielem);
-
+    ins = elemNodes_[ie];
     inodes = rodNodes_[ins];
 
     // TEST_CONTEXT(inodes)
@@ -655,118 +920,193 @@ void SpecialCosseratRodModel::initRotation_()
     }
     LambdaN_[in] = rotMat;
   }
+
+  // reference rotations in structure-of-arrays layout for the batched kernels
+  refRots_.resize(nodeCount, ROT_DOF_COUNT * ROT_DOF_COUNT);
+  nodeRots_.resize(nodeCount, ROT_DOF_COUNT * ROT_DOF_COUNT);
+  for (idx_t j = 0; j < ROT_DOF_COUNT; j++)
+    for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+      refRots_[i + ROT_DOF_COUNT * j] = LambdaN_(i, j, ALL);
+  nodeRots_ = refRots_;
+  rotCacheValid_ = false;
 }
 
 void SpecialCosseratRodModel::getGeomtericStiffness_(const Cubix &B,
                                                      const Matrix &stresses,
                                                      const Matrix &nodePhi_0,
-                                                     const Matrix &nodeU) const
+                                                     const Matrix &nodeU,
+                                                     const idx_t ie) const
 {
-  const idx_t dofCount = dofs_->typeCount();
-  const idx_t globRank = shapeK_->globalRank();
   const idx_t nodeCount = shapeK_->nodeCount();
-  const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
 
-  Vector w(ipCount);
-  Matrix shapeGrads(nodeCount, ipCount);
-  Matrix phiP(globRank, ipCount);
-
-  // get phi_prime
-  shapeK_->getShapeGradients(shapeGrads, w, nodePhi_0);
-  phiP = matmul(Matrix(nodePhi_0 + nodeU), shapeGrads);
+  const Matrix shapeGrads = refGrads_[ie];
+  Vec3 phiP;
 
   // for every iPoint assemble the B-Matrix
   for (idx_t ip = 0; ip < ipCount; ip++)
   {
-    B[ip] = 0.;
-    B[ip](TRANS_PART, SliceFrom(dofCount)) -=
-        skew(stresses[ip][TRANS_PART]);
-    B[ip](ROT_PART, SliceFrom(dofCount)) -= skew(stresses[ip][ROT_PART]);
-    B[ip](SliceFrom(dofCount), TRANS_PART) +=
-        skew(stresses[ip][TRANS_PART]);
-    B[ip](SliceFrom(dofCount), SliceFrom(dofCount)) +=
-        matmul(stresses[ip][TRANS_PART], phiP[ip]);
-    B[ip](SliceFrom(dofCount), SliceFrom(dofCount)) -=
-        dot(stresses[ip][TRANS_PART], phiP[ip]) * eye();
+    // get phi_prime
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+    {
+      phiP[i] = 0.;
+      for (idx_t inode = 0; inode < nodeCount; inode++)
+        phiP[i] += (nodePhi_0(i, inode) + nodeU(i, inode)) * shapeGrads(inode, ip);
+    }
+
+    getGeomStiffAt_(B[ip], stresses[ip], phiP);
   }
 }
 
+void SpecialCosseratRodModel::getGeomStiffAt_(const Matrix &B,
+                                              const Vector &stress,
+                                              const Vec3 &phiP) const
+{
+  const idx_t dofCount = dofs_->typeCount();
+
+  Vec3 n;
+  Mat3 N;
+  Mat3 M;
+  double nDotPhiP;
+
+  for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+    n[i] = stress[i];
+  nDotPhiP = n[0] * phiP[0] + n[1] * phiP[1] + n[2] * phiP[2];
+
+  skew(N, n);
+  for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+    n[i] = stress[TRANS_DOF_COUNT + i];
+  skew(M, n);
+
+  B = 0.;
+  for (idx_t j = 0; j < 3; j++)
+    for (idx_t i = 0; i < 3; i++)
+    {
+      B(i, dofCount + j) = -N(i, j);
+      B(TRANS_DOF_COUNT + i, dofCount + j) = -M(i, j);
+      B(dofCount + i, j) = N(i, j);
+      B(dofCount + i, dofCount + j) =
+          stress[i] * phiP[j] - (i == j ? nDotPhiP : 0.);
+    }
+}
+
 void SpecialCosseratRodModel::getStrains_(
     const Matrix &strains, const Vector &w, const Matrix &nodePhi_0,
     const Matrix &nodeU, const Cubix &nodeLambda, const idx_t ie,
-    const bool spatial) const
+    ElemWork_ &work, const bool spatial) const
 {
-  // TEST_CONTEXT(nodePhi_0)
-  // TEST_CONTEXT(nodeU)
-
-  const idx_t ipCount = shapeK_->ipointCount();
-  const idx_t globRank = shapeK_->globalRank();
-  const idx_t dofCount = dofs_->typeCount();
+  const idx_t ipCount = ipointCount_();
+  const idx_t fullCount = shapeK_->ipointCount();
+  const idx_t nodeCount = shapeK_->nodeCount();
 
-  const Cubix ipLambda(globRank, globRank, ipCount);
-  const Cubix ipPI(dofCount, dofCount, ipCount);
-  const Cubix ipLambdaP(globRank, globRank, ipCount);
-  const Matrix ipPhi(globRank, ipCount);
-  const Matrix ipPhiP(globRank, ipCount);
-  const IdxVector inodes(shapeK_->nodeCount());
+  const Cubix ipLambda = work.strainLambda;
+  const Cubix ipLambdaP = work.strainLambdaP;
 
-  Matrix shapes(shapeK_->shapeFuncCount(), shapeK_->ipointCount());
-  Matrix grads(shapeK_->shapeFuncCount(), shapeK_->ipointCount());
+  const Matrix grads = refGrads_[ie];
 
-  shapes = shapeK_->getShapeFunctions();
-  shapeK_->getShapeGradients(grads, w, nodePhi_0);
-  // TEST_CONTEXT(shapes)
-  // TEST_CONTEXT(grads)
+  Vec3 phiP;
+  Vec3 gamma;
+  Vec3 kappa;
+  Vec3 tmp;
+  Mat3 Lambda;
+  Mat3 LambdaP;
+  Mat3 curv;
 
-  ipPhi = matmul(Matrix(nodePhi_0 + nodeU), shapes);
-  ipPhiP = matmul(Matrix(nodePhi_0 + nodeU), grads);
-  shapeK_->getPi(ipPI, ipLambda, nodeLambda);
-  shapeK_->getRotationGradients(ipLambdaP, w, nodePhi_0, nodeLambda);
+  w = refWeights_[ie];
+  getIpRotations_(ipLambda, nodeLambda);
+  shapeK_->getRotationGradients(ipLambdaP(ALL, ALL, SliceTo(fullCount)),
+                                grads(ALL, SliceTo(fullCount)), nodeLambda);
+  if (shapeR_)
+    shapeR_->getRotationGradients(ipLambdaP(ALL, ALL, SliceFrom(fullCount)),
+                                  grads(ALL, SliceFrom(fullCount)), nodeLambda);
 
   // get the strains (material + spatial );
   for (idx_t ip = 0; ip < ipCount; ip++)
   {
-    strains[ip][TRANS_PART] =
-        matmul(ipLambda[ip].transpose(), ipPhiP[ip]);
-    // TEST_CONTEXT(matmul(ipLambda[ip].transpose(), ipLambdaP[ip]))
-    strains[ip][ROT_PART] =
-        unskew(matmul(ipLambda[ip].transpose(), ipLambdaP[ip]));
-  }
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+    {
+      phiP[i] = 0.;
+      for (idx_t inode = 0; inode < nodeCount; inode++)
+        phiP[i] += (nodePhi_0(i, inode) + nodeU(i, inode)) * grads(inode, ip);
+    }
 
-  // TEST_CONTEXT(strains)
-  strains -= matStrain0_[ie];
-  // TEST_CONTEXT(strains)
+    load(Lambda, ipLambda[ip]);
+    load(LambdaP, ipLambdaP[ip]);
 
-  if (spatial)
-    for (idx_t ip = 0; ip < ipCount; ip++)
-      strains[ip] = matmul(ipPI[ip], strains[ip]);
-  // TEST_CONTEXT(strains)
+    mat3TVec(gamma, Lambda, phiP);
+    mat3TMul(curv, Lambda, LambdaP);
+    unskew(kappa, curv);
+
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+    {
+      gamma[i] -= matStrain0_(i, ip, ie);
+      kappa[i] -= matStrain0_(TRANS_DOF_COUNT + i, ip, ie);
+    }
+
+    if (spatial)
+    {
+      mat3Vec(tmp, Lambda, gamma);
+      gamma = tmp;
+      mat3Vec(tmp, Lambda, kappa);
+      kappa = tmp;
+    }
+
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+    {
+      strains(i, ip) = gamma[i];
+      strains(TRANS_DOF_COUNT + i, ip) = kappa[i];
+    }
+  }
 }
 
 void SpecialCosseratRodModel::getStresses_(
     const Matrix &stresses, const Vector &w, const Matrix &nodePhi_0,
     const Matrix &nodeU, const Cubix &nodeLambda, const idx_t ie,
-    const bool spatial, const String &loadCase) const
+    ElemWork_ &work, const bool spatial, const String &loadCase) const
 {
-  const idx_t ipCount = shapeK_->ipointCount();
-  const idx_t dofCount = dofs_->typeCount();
-  const Matrix strains(stresses.shape());
-  const Cubix stiffness(dofCount, dofCount, ipCount);
-  const Cubix PI(dofCount, dofCount, ipCount);
+  const idx_t ipCount = ipointCount_();
+  const Matrix strains = work.matStrains;
+  const Cubix ipLambda = work.strainLambda;
+
+  Vec3 n;
+  Vec3 m;
+  Vec3 nSpatial;
+  Vec3 mSpatial;
+  Mat3 Lambda;
 
   // get the (material) strains
-  getStrains_(strains, w, nodePhi_0, nodeU, nodeLambda, ie, false);
+  getStrains_(strains, w, nodePhi_0, nodeU, nodeLambda, ie, work, false);
   // TEST_CONTEXT(strains)
 
+  // with selective integration every point only carries its own terms, so
+  // the state and the energy of the material belong to these terms only
+  if (shapeR_)
+    for (idx_t ip = 0; ip < ipCount; ip++)
+      strains(getSkippedPart_(ip), ip) = 0.;
+
   for (idx_t ip = 0; ip < ipCount; ip++)
     material_->getStress(stresses[ip], strains[ip], ie, ip, loadCase != "output");
 
   // get the (spatial) stresses
   if (spatial)
   {
-    shapeK_->getPi(PI, nodeLambda);
+    getIpRotations_(ipLambda, nodeLambda);
     for (idx_t ip = 0; ip < ipCount; ip++)
-      stresses[ip] = matmul(PI[ip], stresses[ip]);
+    {
+      load(Lambda, ipLambda[ip]);
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+      {
+        n[i] = stresses(i, ip);
+        m[i] = stresses(TRANS_DOF_COUNT + i, ip);
+      }
+      mat3Vec(nSpatial, Lambda, n);
+      mat3Vec(mSpatial, Lambda, m);
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+      {
+        stresses(i, ip) = nSpatial[i];
+        stresses(TRANS_DOF_COUNT + i, ip) = mSpatial[i];
+      }
+    }
   }
 }
 
@@ -774,124 +1114,204 @@ void SpecialCosseratRodModel::getDisplacments_(const Matrix &nodePhi_0,
                                                const Matrix &nodeU,
                                                const Cubix &nodeLambda,
                                                const Vector &disp,
-                                               const IdxVector &inodes) const
+                                               const idx_t ie) const
 {
-  const idx_t nodeCount = inodes.size();
-
-  IdxVector idofs_trans(TRANS_DOF_COUNT);
-  IdxVector idofs_rot(ROT_DOF_COUNT);
+  const idx_t nodeCount = elemNodes_.size(0);
+  const idx_t dofCount = dofs_->typeCount();
+  const IdxVector inodes = elemNodes_[ie];
+  const IdxVector idofs = elemDofs_[ie];
 
-  // TEST_CONTEXT(inodes)
-  allNodes_.getSomeCoords(nodePhi_0, inodes);
-  // TEST_CONTEXT(nodePhi_0)
+  nodePhi_0 = refCoords_[ie];
 
   for (idx_t inode = 0; inode < nodeCount; inode++)
   {
-    dofs_->getDofIndices(idofs_trans, inodes[inode], transTypes_);
-    dofs_->getDofIndices(idofs_rot, inodes[inode], rotTypes_);
+    const idx_t irod = rodNodes_[inodes[inode]];
+
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+      nodeU(i, inode) = disp[idofs[inode * dofCount + i]];
 
-    nodeU[inode] = disp[idofs_trans];
-    expVec(nodeLambda[inode], Vector(disp[idofs_rot]));
-    nodeLambda[inode] =
-        matmul(nodeLambda[inode], LambdaN_[rodNodes_[inodes[inode]]]);
+    // rotations are evaluated for all nodes at once (updateNodeRotations_)
+    for (idx_t j = 0; j < ROT_DOF_COUNT; j++)
+      for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+        nodeLambda(i, j, inode) = nodeRots_(irod, i + ROT_DOF_COUNT * j);
   }
 }
 
-void SpecialCosseratRodModel::assemble_(MatrixBuilder &mbld,
-                                        const Vector &fint,
-                                        const Vector &disp,
-                                        const String &loadCase) const
+void SpecialCosseratRodModel::updateNodeRotations_(const Vector &disp)
+{
+  // the cached rotations belong to the current state (see takeAction)
+  if (rotCacheValid_)
+    return;
+
+  // structure-of-arrays layout (one rod node per row)
+  for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+    rotVecs_[i] = disp[nodeDofs_(TRANS_DOF_COUNT + i, ALL)];
+
+  expVecBatch(rotExp_, rotVecs_);
+  composeBatch(nodeRots_, rotExp_, refRots_);
+
+  rotCacheValid_ = true;
+}
+
+idx_t SpecialCosseratRodModel::ipointCount_() const
+{
+  if (shapeR_)
+    return shapeK_->ipointCount() + shapeR_->ipointCount();
+  else
+    return shapeK_->ipointCount();
+}
+
+Slice SpecialCosseratRodModel::getSkippedPart_(const idx_t ip) const
+{
+  // curvature terms at the full points, shear/axial terms at the reduced ones
+  return ip < shapeK_->ipointCount() ? TRANS_PART : ROT_PART;
+}
+
+void SpecialCosseratRodModel::getIpRotations_(const Cubix &ipLambda,
+                                              const Cubix &nodeLambda) const
+{
+  const idx_t fullCount = shapeK_->ipointCount();
+
+  shapeK_->getRotations(ipLambda(ALL, ALL, SliceTo(fullCount)), nodeLambda);
+  if (shapeR_)
+    shapeR_->getRotations(ipLambda(ALL, ALL, SliceFrom(fullCount)), nodeLambda);
+}
+
+void SpecialCosseratRodModel::getXi_(ElemWork_ &work,
+                                     const idx_t ie) const
+{
+  const idx_t fullCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
+  const Matrix grads = refGrads_[ie];
+
+  if (!shapeR_)
+  {
+    shapeK_->getXi(work.XI, grads, work.nodeU, work.nodePhi_0);
+    return;
+  }
+
+  shapeK_->getXi(work.XIK, grads(ALL, SliceTo(fullCount)), work.nodeU, work.nodePhi_0);
+  shapeR_->getXi(work.XIR, grads(ALL, SliceFrom(fullCount)), work.nodeU, work.nodePhi_0);
+
+  for (idx_t ip = 0; ip < ipCount; ip++)
+    work.XI[ip] = ip < fullCount ? work.XIK[ip] : work.XIR[ip - fullCount];
+}
+
+void SpecialCosseratRodModel::updateOutput_(const Vector &disp)
 {
-  const idx_t ipCount = shapeK_->ipointCount();
-  const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t elemCount = rodElems_.size();
+  const idx_t ipCount = ipointCount_();
   const idx_t dofCount = dofs_->typeCount();
-  const idx_t rank = shapeK_->globalRank();
-  MatmulChain<double, 3> mc3;
 
-  // PER ELEMENT VALUES
-  Matrix nodeU(rank, nodeCount);
-  Matrix nodePhi_0(rank, nodeCount);
-  Cubix nodeLambda(rank, rank, nodeCount);
-  Matrix stress(dofCount, ipCount);
-  Vector weights(ipCount);
-  Quadix XI(dofCount, dofCount, nodeCount, ipCount);
-  Quadix PSI(dofCount, dofCount + TRANS_DOF_COUNT, nodeCount, ipCount);
-  Cubix PI(dofCount, dofCount, ipCount);
-  Matrix spatialC(dofCount, dofCount);
-  Cubix geomStiff(dofCount + TRANS_DOF_COUNT, dofCount + TRANS_DOF_COUNT,
-                  ipCount);
+  // the output values belong to the same state
+  if (outputValid_ && disp.size() == outDisp_.size() &&
+      jem::testall(disp == outDisp_))
+    return;
 
-  // DOF INDICES
-  IdxVector inodes(nodeCount);
-  IdxVector Idofs(dofCount);
-  IdxVector Jdofs(dofCount);
+  outStrain_.resize(dofCount, ipCount, elemCount);
+  outMatStrain_.resize(dofCount, ipCount, elemCount);
+  outStress_.resize(dofCount, ipCount, elemCount);
+  outMatStress_.resize(dofCount, ipCount, elemCount);
+  outPotEnergy_.resize(ipCount, elemCount);
+  outDissEnergy_.resize(ipCount, elemCount);
 
-  // HELPERS
-  Matrix addS(dofCount, dofCount);
-  Matrix addT(dofCount, dofCount);
+  // kinematics and material are evaluated once for all output quantities
+  jive_helpers::parallelFor(0, elemCount, threadCount_, [&](const idx_t ie)
+                            { getElemOutput_(ie, disp, getElemWork_()); });
 
-  // iterate through the elements
-  for (idx_t ie = 0; ie < elemCount; ie++)
+  outDisp_.ref(disp.clone());
+  outputValid_ = true;
+}
+
+void SpecialCosseratRodModel::getElemOutput_(const idx_t ie,
+                                             const Vector &disp,
+                                             ElemWork_ &work)
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t dofCount = dofs_->typeCount();
+
+  // PER ELEMENT VALUES (work arrays of this thread)
+  const Matrix nodeU = work.nodeU;
+  const Matrix nodePhi_0 = work.nodePhi_0;
+  const Cubix nodeLambda = work.nodeLambda;
+  const Cubix ipLambda = work.ipLambda;
+  const Vector weights = work.weights;
+  const Vector ipStrain = work.ipStrain;
+  const Vector ipStress = work.ipStress;
+  Vec3 mat;
+  Vec3 spat;
+  Mat3 Lambda;
+
+  getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
+  getStrains_(outMatStrain_[ie], weights, nodePhi_0, nodeU, nodeLambda, ie,
+              work, false);
+  getIpRotations_(ipLambda, nodeLambda);
+
+  for (idx_t ip = 0; ip < ipCount; ip++)
   {
-    // REPORT(ie)
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    // TEST_CONTEXT( rodElems_.getIndex(ie) )
-    // TEST_CONTEXT( inodes )
-    // get nice Positions
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
+    // output only, do not advance the inelastic state (as the "output" load case)
+    material_->getStress(outMatStress_(ALL, ip, ie), outMatStrain_(ALL, ip, ie),
+                         ie, ip, false);
 
-    // TEST_CONTEXT(inodes)
-    // TEST_CONTEXT(nodePhi_0)
-    // TEST_CONTEXT(nodeU)
-    // TEST_CONTEXT(nodeLambda)
-
-    // get the XI, PSI and PI values for this
-    shapeK_->getXi(XI, weights, nodeU, nodePhi_0);
-    shapeK_->getPsi(PSI, weights, nodePhi_0);
-    shapeK_->getPi(PI, nodeLambda);
-    // TEST_CONTEXT(XI)
-    // TEST_CONTEXT(PSI)
-    // TEST_CONTEXT(PI)
-    // get the (spatial) stresses
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, true, loadCase);
-    // get the gemetric stiffness
-    getGeomtericStiffness_(geomStiff, stress, nodePhi_0, nodeU);
-    // TEST_CONTEXT(geomStiff)
-
-    // iterate through the integration Points
-    for (idx_t ip = 0; ip < ipCount; ip++)
+    // the full strains are reported, but the material keeps the terms of
+    // this point only (as in getStresses_)
+    if (shapeR_)
     {
-      // get the spatial stiffness
-      spatialC = mc3.matmul(PI[ip], material_->getMaterialStiff(ie, ip), PI[ip].transpose());
-      // TEST_CONTEXT(PI[ip])
-      // TEST_CONTEXT(material_->getMaterialStiff(ie, ip))
+      ipStrain = outMatStrain_(ALL, ip, ie);
+      ipStrain[getSkippedPart_(ip)] = 0.;
+      material_->getStress(ipStress, ipStrain, ie, ip, false);
+    }
+    outPotEnergy_(ip, ie) = material_->getPotentialEnergy(ie, ip);
+    outDissEnergy_(ip, ie) = material_->getDissipatedEnergy(ie, ip);
 
-      for (idx_t Inode = 0; Inode < nodeCount; Inode++)
-      {
-        dofs_->getDofIndices(Idofs, inodes[Inode], jtypes_);
-
-        for (idx_t Jnode = 0; Jnode < nodeCount; Jnode++)
-        {
-          // SUBHEADER2( Inode, Jnode)
-          dofs_->getDofIndices(Jdofs, inodes[Jnode], jtypes_);
-
-          // Stiffness contribution S ( element stiffness matrix )
-          addS = weights[ip] * mc3.matmul(XI[ip][Inode], spatialC,
-                                          XI[ip][Jnode].transpose());
-          // TEST_CONTEXT(addS)
-          mbld.addBlock(Idofs, Jdofs, addS);
-
-          // Stiffness contribution T ( element geometric
-          // stiffness matrix)
-          addT = weights[ip] * mc3.matmul(PSI[ip][Inode], geomStiff[ip],
-                                          PSI[ip][Jnode].transpose());
-          // TEST_CONTEXT(addT)
-          if (!symOnly_)
-            mbld.addBlock(Idofs, Jdofs, addT);
-        }
-        fint[Idofs] += weights[ip] * matmul(XI[ip][Inode], stress[ip]);
-      }
+    // transform strains and stresses into the spatial frame
+    load(Lambda, ipLambda[ip]);
+    for (idx_t part = 0; part < dofCount; part += TRANS_DOF_COUNT)
+    {
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+        mat[i] = outMatStrain_(part + i, ip, ie);
+      mat3Vec(spat, Lambda, mat);
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+        outStrain_(part + i, ip, ie) = spat[i];
+
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+        mat[i] = outMatStress_(part + i, ip, ie);
+      mat3Vec(spat, Lambda, mat);
+      for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+        outStress_(part + i, ip, ie) = spat[i];
+    }
+  }
+}
+
+void SpecialCosseratRodModel::assemble_(MatrixBuilder &mbld,
+                                        const Vector &fint,
+                                        const Vector &disp,
+                                        const String &loadCase) const
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t elemDofCount = elemDofs_.size(0);
+  const idx_t chunkSize = jem::max(jem::min(elemCount, 32 * threadCount_), (idx_t)1);
+
+  // PER ELEMENT BUFFERS
+  Cubix elemK(elemDofCount, elemDofCount, chunkSize);
+  Matrix elemF(elemDofCount, chunkSize);
+
+  // iterate through the elements chunk by chunk
+  for (idx_t ie0 = 0; ie0 < elemCount; ie0 += chunkSize)
+  {
+    const idx_t ie1 = jem::min(ie0 + chunkSize, elemCount);
+
+    // evaluate the elements of this chunk (possibly concurrently)
+    jive_helpers::parallelFor(ie0, ie1, threadCount_, [&](const idx_t ie)
+                              { getElemContrib_(elemK[ie - ie0], elemF[ie - ie0],
+                                                ie, disp, loadCase, getElemWork_()); });
+
+    // scatter the element matrices and vectors in element order, so the
+    // result does not depend on the number of threads
+    for (idx_t ie = ie0; ie < ie1; ie++)
+    {
+      mbld.addBlock(elemDofs_[ie], elemDofs_[ie], elemK[ie - ie0]);
+      fint[elemDofs_[ie]] += elemF[ie - ie0];
     }
   }
 }
@@ -900,50 +1320,335 @@ void SpecialCosseratRodModel::assemble_(const Vector &fint,
                                         const Vector &disp,
                                         const String &loadCase) const
 {
-  const idx_t ipCount = shapeK_->ipointCount();
-  const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t elemCount = rodElems_.size();
+  const idx_t elemDofCount = elemDofs_.size(0);
+  const idx_t chunkSize = jem::max(jem::min(elemCount, 32 * threadCount_), (idx_t)1);
+
+  // PER ELEMENT BUFFERS
+  Matrix elemF(elemDofCount, chunkSize);
+
+  // iterate through the elements chunk by chunk
+  for (idx_t ie0 = 0; ie0 < elemCount; ie0 += chunkSize)
+  {
+    const idx_t ie1 = jem::min(ie0 + chunkSize, elemCount);
+
+    // evaluate the elements of this chunk (possibly concurrently)
+    jive_helpers::parallelFor(ie0, ie1, threadCount_, [&](const idx_t ie)
+                              { getElemForce_(elemF[ie - ie0], ie, disp, loadCase,
+                                              getElemWork_()); });
+
+    // scatter the element vectors in element order
+    for (idx_t ie = ie0; ie < ie1; ie++)
+      fint[elemDofs_[ie]] += elemF[ie - ie0];
+  }
+}
+
+void SpecialCosseratRodModel::getElemContrib_(const Matrix &elemK,
+                                              const Vector &elemF,
+                                              const idx_t ie,
+                                              const Vector &disp,
+                                              const String &loadCase,
+                                              ElemWork_ &work) const
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t dofCount = dofs_->typeCount();
-  const idx_t rank = shapeK_->globalRank();
   MatmulChain<double, 3> mc3;
 
-  // PER ELEMENT VALUES
-  Matrix nodeU(rank, nodeCount);
-  Matrix nodePhi_0(rank, nodeCount);
-  Cubix nodeLambda(rank, rank, nodeCount);
-  Matrix stress(dofCount, ipCount);
-  Vector weights(ipCount);
-  Quadix XI(dofCount, dofCount, nodeCount, ipCount);
-  // DOF INDICES
-  IdxVector inodes(nodeCount);
-  IdxVector Idofs(dofCount);
+  // PER ELEMENT VALUES (work arrays of this thread)
+  const Matrix nodeU = work.nodeU;
+  const Matrix nodePhi_0 = work.nodePhi_0;
+  const Cubix nodeLambda = work.nodeLambda;
+  const Matrix stress = work.stress;
+  const Vector weights = work.weights;
+  const Quadix XI = work.XI;
+  const Cubix ipLambda = work.ipLambda;
+  const Matrix spatialC = work.spatialC;
+  const Cubix geomStiff = work.geomStiff;
+  Mat3 Lambda;
+  Mat6 materialC;
+  Mat6 spatialCFix;
+
+  // ELEMENT OPERATORS (all nodes stacked)
+  const Matrix elemXI = work.elemXI;
+  Matrix elemPSI;
+
+  // get nice Positions
+  getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
+
+  // get the XI and rotation values for this (PSI is stored per element)
+  getXi_(work, ie);
+  getIpRotations_(ipLambda, nodeLambda);
+  // get the (spatial) stresses
+  getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, work, true, loadCase);
+  if (shapeR_)
+    for (idx_t ip = 0; ip < ipCount; ip++)
+      stress(getSkippedPart_(ip), ip) = 0.;
+  // get the gemetric stiffness
+  getGeomtericStiffness_(geomStiff, stress, nodePhi_0, nodeU, ie);
 
-  // iterate through the elements
-  for (idx_t ie = 0; ie < elemCount; ie++)
+  elemK = 0.;
+  elemF = 0.;
+
+  // iterate through the integration Points
+  for (idx_t ip = 0; ip < ipCount; ip++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    // get the nice positions
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
+    // get the spatial stiffness
+    load(Lambda, ipLambda[ip]);
+    load(materialC, material_->getMaterialStiff(ie, ip));
+    pushForward(spatialCFix, Lambda, materialC);
+    store(spatialC, spatialCFix);
+    if (shapeR_)
+      spatialC(getSkippedPart_(ip), ALL) = 0.;
+
+    for (idx_t Inode = 0; Inode < nodeCount; Inode++)
+      elemXI(SliceFromTo(Inode * dofCount, (Inode + 1) * dofCount), ALL) = XI[ip][Inode];
+    elemPSI.ref(refPsi_[ie][ip]);
+
+    // Stiffness contribution S ( element stiffness matrix )
+    elemK += weights[ip] * mc3.matmul(elemXI, spatialC, elemXI.transpose());
+
+    // Stiffness contribution T ( element geometric stiffness matrix)
+    if (!symOnly_)
+      elemK += weights[ip] * mc3.matmul(elemPSI, geomStiff[ip], elemPSI.transpose());
+
+    elemF += weights[ip] * matmul(elemXI, stress[ip]);
+  }
+}
 
-    // TEST_CONTEXT(inodes)
-    // TEST_CONTEXT(nodePhi_0)
-    // TEST_CONTEXT(nodeU)
-    // TEST_CONTEXT(nodeLambda)
+void SpecialCosseratRodModel::getElemForce_(const Vector &elemF,
+                                            const idx_t ie,
+                                            const Vector &disp,
+                                            const String &loadCase,
+                                            ElemWork_ &work) const
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t dofCount = dofs_->typeCount();
 
-    // get the XI values for this
-    shapeK_->getXi(XI, weights, nodeU, nodePhi_0);
-    // get the (spatial) stresses
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, true, loadCase);
+  // PER ELEMENT VALUES (work arrays of this thread)
+  const Matrix nodeU = work.nodeU;
+  const Matrix nodePhi_0 = work.nodePhi_0;
+  const Cubix nodeLambda = work.nodeLambda;
+  const Matrix stress = work.stress;
+  const Vector weights = work.weights;
+  const Quadix XI = work.XI;
 
-    // iterate through the integration Points
+  // get the nice positions
+  getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
+
+  // get the XI values for this
+  getXi_(work, ie);
+  // get the (spatial) stresses
+  getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, work, true, loadCase);
+  if (shapeR_)
     for (idx_t ip = 0; ip < ipCount; ip++)
+      stress(getSkippedPart_(ip), ip) = 0.;
+
+  elemF = 0.;
+
+  // iterate through the integration Points
+  for (idx_t ip = 0; ip < ipCount; ip++)
+    for (idx_t Inode = 0; Inode < nodeCount; Inode++)
+      elemF[SliceFromTo(Inode * dofCount, (Inode + 1) * dofCount)] +=
+          weights[ip] * matmul(XI[ip][Inode], stress[ip]);
+}
+
+void SpecialCosseratRodModel::assembleTangentState_(const Vector &fint,
+                                                   const Vector &disp,
+                                                   const String &loadCase)
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t ipCount = ipointCount_();
+  const idx_t dofCount = dofs_->typeCount();
+  const idx_t elemDofCount = elemDofs_.size(0);
+  const idx_t chunkSize = jem::max(jem::min(elemCount, 32 * threadCount_), (idx_t)1);
+
+  // PER ELEMENT BUFFERS
+  Matrix elemF(elemDofCount, chunkSize);
+
+  tanPhiP_.resize(TRANS_DOF_COUNT, ipCount, elemCount);
+  tanStress_.resize(dofCount, ipCount, elemCount);
+  tanC_.resize(dofCount, dofCount, ipCount, elemCount);
+
+  // iterate through the elements chunk by chunk
+  for (idx_t ie0 = 0; ie0 < elemCount; ie0 += chunkSize)
+  {
+    const idx_t ie1 = jem::min(ie0 + chunkSize, elemCount);
+
+    // evaluate the elements of this chunk (possibly concurrently)
+    jive_helpers::parallelFor(ie0, ie1, threadCount_, [&](const idx_t ie)
+                              { getElemTangentState_(elemF[ie - ie0], ie, disp, loadCase,
+                                                     getElemWork_()); });
+
+    // scatter the element vectors in element order
+    for (idx_t ie = ie0; ie < ie1; ie++)
+      fint[elemDofs_[ie]] += elemF[ie - ie0];
+  }
+
+  tangent_->newValuesEvent.emit(*tangent_);
+}
+
+void SpecialCosseratRodModel::getElemTangentState_(const Vector &elemF,
+                                                   const idx_t ie,
+                                                   const Vector &disp,
+                                                   const String &loadCase,
+                                                   ElemWork_ &work)
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t dofCount = dofs_->typeCount();
+
+  // PER ELEMENT VALUES (work arrays of this thread)
+  const Matrix nodeU = work.nodeU;
+  const Matrix nodePhi_0 = work.nodePhi_0;
+  const Cubix nodeLambda = work.nodeLambda;
+  const Matrix stress = work.stress;
+  const Vector weights = work.weights;
+  const Quadix XI = work.XI;
+  const Cubix ipLambda = work.ipLambda;
+  Mat3 Lambda;
+  Mat6 materialC;
+  Mat6 spatialC;
+
+  // get the nice positions
+  getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
+
+  // get the XI and rotation values for this
+  getXi_(work, ie);
+  getIpRotations_(ipLambda, nodeLambda);
+  // get the (spatial) stresses
+  getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, work, true, loadCase);
+  if (shapeR_)
+    for (idx_t ip = 0; ip < ipCount; ip++)
+      stress(getSkippedPart_(ip), ip) = 0.;
+
+  elemF = 0.;
+
+  // iterate through the integration Points
+  for (idx_t ip = 0; ip < ipCount; ip++)
+  {
+    // keep the linearization point
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
     {
-      for (idx_t Inode = 0; Inode < nodeCount; Inode++)
-      {
-        dofs_->getDofIndices(Idofs, inodes[Inode], jtypes_);
+      tanPhiP_(i, ip, ie) = 0.;
+      for (idx_t inode = 0; inode < nodeCount; inode++)
+        tanPhiP_(i, ip, ie) += (nodePhi_0(i, inode) + nodeU(i, inode)) * refGrads_(inode, ip, ie);
+    }
+    tanStress_(ALL, ip, ie) = stress[ip];
+
+    load(Lambda, ipLambda[ip]);
+    load(materialC, material_->getMaterialStiff(ie, ip));
+    pushForward(spatialC, Lambda, materialC);
+    store(tanC_[ie][ip], spatialC);
+    if (shapeR_)
+      tanC_[ie][ip](getSkippedPart_(ip), ALL) = 0.;
+
+    for (idx_t Inode = 0; Inode < nodeCount; Inode++)
+      elemF[SliceFromTo(Inode * dofCount, (Inode + 1) * dofCount)] +=
+          weights[ip] * matmul(XI[ip][Inode], stress[ip]);
+  }
+}
 
-        fint[Idofs] += weights[ip] * matmul(XI[ip][Inode], stress[ip]);
-      }
+void SpecialCosseratRodModel::applyTangent_(const Vector &lhs,
+                                            const Vector &rhs) const
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t elemDofCount = elemDofs_.size(0);
+  const idx_t chunkSize = jem::max(jem::min(elemCount, 32 * threadCount_), (idx_t)1);
+
+  // PER ELEMENT BUFFERS
+  Matrix elemY(elemDofCount, chunkSize);
+
+  lhs = 0.;
+
+  // iterate through the elements chunk by chunk
+  for (idx_t ie0 = 0; ie0 < elemCount; ie0 += chunkSize)
+  {
+    const idx_t ie1 = jem::min(ie0 + chunkSize, elemCount);
+
+    // evaluate the elements of this chunk (possibly concurrently)
+    jive_helpers::parallelFor(ie0, ie1, threadCount_, [&](const idx_t ie)
+                              {
+                                ElemWork_ &work = getElemWork_();
+
+                                for (idx_t i = 0; i < elemDofCount; i++)
+                                  work.elemX[i] = rhs[elemDofs_(i, ie)];
+                                applyElemTangent_(elemY[ie - ie0], work.elemX, ie, work); });
+
+    // scatter the element products in element order
+    for (idx_t ie = ie0; ie < ie1; ie++)
+      lhs[elemDofs_[ie]] += elemY[ie - ie0];
+  }
+}
+
+void SpecialCosseratRodModel::applyElemTangent_(const Vector &elemY,
+                                                const Vector &elemX,
+                                                const idx_t ie,
+                                                ElemWork_ &work) const
+{
+  const idx_t ipCount = ipointCount_();
+  const idx_t nodeCount = shapeK_->nodeCount();
+  const idx_t dofCount = dofs_->typeCount();
+
+  // work arrays of this thread
+  const Vector strain = work.ipStrain;
+  const Vector stress = work.ipStress;
+  const Vector psiX = work.psiX;
+  const Vector psiY = work.psiY;
+  const Matrix B = work.B;
+  Matrix PSI;
+  Vec3 phiP;
+  Mat3 PhiP;
+
+  elemY = 0.;
+
+  // iterate through the integration Points
+  for (idx_t ip = 0; ip < ipCount; ip++)
+  {
+    const double w = refWeights_(ip, ie);
+
+    for (idx_t i = 0; i < TRANS_DOF_COUNT; i++)
+      phiP[i] = tanPhiP_(i, ip, ie);
+    skew(PhiP, phiP);
+
+    // material part: XI * C * XI^T * x
+    strain = 0.;
+    for (idx_t inode = 0; inode < nodeCount; inode++)
+    {
+      const double g = refGrads_(inode, ip, ie);
+      const double N = ipShapes_(inode, ip);
+
+      for (idx_t i = 0; i < dofCount; i++)
+        strain[i] += g * elemX[inode * dofCount + i];
+      for (idx_t j = 0; j < TRANS_DOF_COUNT; j++)
+        for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+          strain[j] -= N * PhiP(i, j) * elemX[inode * dofCount + TRANS_DOF_COUNT + i];
+    }
+
+    stress = matmul(tanC_[ie][ip], strain);
+
+    for (idx_t inode = 0; inode < nodeCount; inode++)
+    {
+      const double g = refGrads_(inode, ip, ie);
+      const double N = ipShapes_(inode, ip);
+
+      for (idx_t i = 0; i < dofCount; i++)
+        elemY[inode * dofCount + i] += w * g * stress[i];
+      for (idx_t i = 0; i < ROT_DOF_COUNT; i++)
+        for (idx_t j = 0; j < TRANS_DOF_COUNT; j++)
+          elemY[inode * dofCount + TRANS_DOF_COUNT + i] -= w * N * PhiP(i, j) * stress[j];
+    }
+
+    // geometric part: PSI * B * PSI^T * x
+    if (!symOnly_)
+    {
+      PSI.ref(refPsi_[ie][ip]);
+      getGeomStiffAt_(B, tanStress_(ALL, ip, ie), phiP);
+
+      psiX = matmul(PSI.transpose(), elemX);
+      psiY = matmul(B, psiX);
+      elemY += w * matmul(PSI, psiY);
     }
   }
 }
@@ -958,9 +1663,9 @@ void SpecialCosseratRodModel::assembleGyro_(const Vector &fgyro,
 
   mass->matmul(temp, velo);
 
-  for (idx_t inode : rodElems_.getNodeIndices())
+  for (idx_t inode = 0; inode < nodeDofs_.size(1); inode++)
   {
-    dofs_->getDofIndices(idofs, inode, rotTypes_);
+    idofs = nodeDofs_(ROT_PART, inode);
 
     fgyro[idofs] += matmul(skew(Vector(velo[idofs])), Vector(temp[idofs]));
   }
@@ -978,7 +1683,6 @@ void SpecialCosseratRodModel::assembleM_(MatrixBuilder &mbld, Vector &disp) cons
   const idx_t ipCount = shapeM_->ipointCount();
 
   // PER ELEMENT VALUES
-  IdxVector inodes(nodeCount);
   IdxVector idofs(dofCount);
   IdxVector jdofs(dofCount);
 
@@ -996,21 +1700,20 @@ void SpecialCosseratRodModel::assembleM_(MatrixBuilder &mbld, Vector &disp) cons
   // iterate through the elements
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
+    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
     shapeM_->getRotations(ipLambda, nodeLambda);
 
-    shapeM_->getIntegrationWeights(weights, nodePhi_0);
+    weights = refMassWeights_[ie];
     shapes = shapeM_->getShapeFunctions();
 
     l = sum(weights) / (nodeCount - 1);
 
     for (idx_t inode = 0; inode < nodeCount; inode++)
     {
-      dofs_->getDofIndices(idofs, inodes[inode], jtypes_);
+      idofs = elemDofs_(SliceFromTo(inode * dofCount, (inode + 1) * dofCount), ie);
       for (idx_t jnode = 0; jnode < nodeCount; jnode++)
       {
-        dofs_->getDofIndices(jdofs, inodes[jnode], jtypes_);
+        jdofs = elemDofs_(SliceFromTo(jnode * dofCount, (jnode + 1) * dofCount), ie);
 
         spatialInertia = 0;
 
@@ -1030,41 +1733,105 @@ void SpecialCosseratRodModel::assembleM_(MatrixBuilder &mbld, Vector &disp) cons
   }
 }
 
-void SpecialCosseratRodModel::getPotentialEnergy_(XTable &energy_table, const Vector &table_weights, const Vector &disp) const
+double SpecialCosseratRodModel::getStableStep_() const
 {
+  const idx_t nodeCount = shapeM_->nodeCount();
   const idx_t elemCount = rodElems_.size();
   const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t massCount = shapeM_->ipointCount();
+  const Matrix massShapes = shapeM_->getShapeFunctions();
+
+  double dtime = jem::Float::MAX_VALUE;
+  double l;
+  double lambdaT;
+  double lambdaR;
+  double omega2;
+  double rowSum;
+  double massT;
+  double massR;
+  Matrix C(TRANS_DOF_COUNT + ROT_DOF_COUNT, TRANS_DOF_COUNT + ROT_DOF_COUNT);
+  Matrix M(TRANS_DOF_COUNT + ROT_DOF_COUNT, TRANS_DOF_COUNT + ROT_DOF_COUNT);
+
+  for (idx_t ie = 0; ie < elemCount; ie++)
+  {
+    // node spacing of the rotational lumped mass
+    l = sum(refMassWeights_[ie]) / (nodeCount - 1);
+    C = material_->getMaterialStiff(ie, 0);
+    M = material_->getMaterialMass(ie, 0);
+
+    // Gershgorin bound on the largest eigenvalue of the element
+    // Laplacian against the lumped nodal masses (per unit stiffness
+    // and density); unlike a uniform node spacing this holds for
+    // higher order elements with unequal nodal masses as well
+    lambdaT = 0.;
+    lambdaR = 0.;
+    for (idx_t inode = 0; inode < nodeCount; inode++)
+    {
+      rowSum = 0.;
+      for (idx_t jnode = 0; jnode < nodeCount; jnode++)
+      {
+        double Kij = 0.;
+        for (idx_t ip = 0; ip < ipCount; ip++)
+          Kij += refWeights_(ip, ie) * refGrads_(inode, ip, ie) * refGrads_(jnode, ip, ie);
+        rowSum += jem::abs(Kij);
+      }
+
+      massT = 0.;
+      for (idx_t ip = 0; ip < massCount; ip++)
+        massT += refMassWeights_(ip, ie) * massShapes(inode, ip);
+      massR = (inode == 0 || inode == nodeCount - 1) ? l / 2. : l;
+
+      if (massT > 0.)
+        lambdaT = jem::max(lambdaT, rowSum / massT);
+      lambdaR = jem::max(lambdaR, rowSum / massR);
+    }
+
+    omega2 = 0.;
+
+    // shear and axial waves
+    for (idx_t i : {0, 1, 2})
+      if (M(i, i) > 0.)
+        omega2 = jem::max(omega2, lambdaT * C(i, i) / M(i, i));
+
+    // torsional waves
+    if (M(5, 5) > 0.)
+      omega2 = jem::max(omega2, lambdaR * C(5, 5) / M(5, 5));
+
+    // bending waves, the rotations are also held by the shear stiffness
+    for (idx_t i : {3, 4})
+      if (M(i, i) > 0.)
+        omega2 = jem::max(omega2, (lambdaR * C(i, i) + jem::max(C(0, 0), C(1, 1))) / M(i, i));
+
+    if (omega2 > 0.)
+      dtime = jem::min(dtime, 2. / sqrt(omega2));
+  }
+
+  return dtime;
+}
+
+void SpecialCosseratRodModel::getPotentialEnergy_(XTable &energy_table, const Vector &table_weights, const Vector &disp)
+{
+  const idx_t elemCount = rodElems_.size();
+  const idx_t ipCount = ipointCount_();
   const idx_t nodeCount = shapeK_->nodeCount();
-  const idx_t rank = shapeK_->globalRank();
-  const idx_t dofCount = dofs_->typeCount();
   const idx_t jCol = energy_table.addColumn("potentialEnergy");
 
-  // PER ELEMENT VALUES
-  Matrix nodeU(rank, nodeCount);
-  Matrix nodePhi_0(rank, nodeCount);
-  Cubix nodeLambda(rank, rank, nodeCount);
-  Matrix strain(dofCount, ipCount);
-  Matrix stress(dofCount, ipCount);
-  Vector weights(ipCount);
-  Matrix shapes(shapeK_->shapeFuncCount(), ipCount);
+  // PER ELEMENT VALUES (all points, see getSkippedPart_)
+  const Matrix shapes = ipShapes_;
   // DOF INDICES
   IdxVector inodes(nodeCount);
 
+  updateOutput_(disp);
+
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, false);
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, false, "output");
-
-    shapes = shapeK_->getShapeFunctions();
+    inodes = elemNodes_[ie];
 
     for (idx_t iNode = 0; iNode < nodeCount; iNode++)
     {
       for (idx_t ip = 0; ip < ipCount; ip++)
       {
-        energy_table.addValue(inodes[iNode], jCol, shapes(iNode, ip) * weights[ip] * material_->getPotentialEnergy(ie, ip));
+        energy_table.addValue(inodes[iNode], jCol, shapes(iNode, ip) * refWeights_(ip, ie) * outPotEnergy_(ip, ie));
         table_weights[inodes[iNode]] = 1.;
       }
     }
@@ -1074,12 +1841,14 @@ void SpecialCosseratRodModel::getPotentialEnergy_(XTable &energy_table, const Ve
 double SpecialCosseratRodModel::getPotentialEnergy_(const Vector &disp) const
 {
   const idx_t elemCount = rodElems_.size();
-  const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
   const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t rank = shapeK_->globalRank();
   const idx_t dofCount = dofs_->typeCount();
   double E_pot = 0.;
 
+  ElemWork_ &work = getElemWork_();
+
   // PER ELEMENT VALUES
   Matrix nodeU(rank, nodeCount);
   Matrix nodePhi_0(rank, nodeCount);
@@ -1087,19 +1856,15 @@ double SpecialCosseratRodModel::getPotentialEnergy_(const Vector &disp) const
   Matrix strain(dofCount, ipCount);
   Matrix stress(dofCount, ipCount);
   Vector weights(ipCount);
-  Matrix shapes(shapeK_->shapeFuncCount(), ipCount);
-  // DOF INDICES
-  IdxVector inodes(nodeCount);
+  // all points, see getSkippedPart_
+  const Matrix shapes = ipShapes_;
 
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, false);
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, false, "output");
+    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
 
-    shapes = shapeK_->getShapeFunctions();
+    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, work, false);
+    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, work, false, "output");
 
     for (idx_t iNode = 0; iNode < nodeCount; iNode++)
     {
@@ -1113,41 +1878,29 @@ double SpecialCosseratRodModel::getPotentialEnergy_(const Vector &disp) const
   return E_pot;
 }
 
-void SpecialCosseratRodModel::getDissipatedEnergy_(XTable &energy_table, const Vector &table_weights, const Vector &disp) const
+void SpecialCosseratRodModel::getDissipatedEnergy_(XTable &energy_table, const Vector &table_weights, const Vector &disp)
 {
   const idx_t elemCount = rodElems_.size();
-  const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
   const idx_t nodeCount = shapeK_->nodeCount();
-  const idx_t rank = shapeK_->globalRank();
-  const idx_t dofCount = dofs_->typeCount();
   const idx_t jCol = energy_table.addColumn("potentialEnergy");
 
-  // PER ELEMENT VALUES
-  Matrix nodeU(rank, nodeCount);
-  Matrix nodePhi_0(rank, nodeCount);
-  Cubix nodeLambda(rank, rank, nodeCount);
-  Matrix strain(dofCount, ipCount);
-  Matrix stress(dofCount, ipCount);
-  Vector weights(ipCount);
-  Matrix shapes(shapeK_->shapeFuncCount(), ipCount);
+  // PER ELEMENT VALUES (all points, see getSkippedPart_)
+  const Matrix shapes = ipShapes_;
   // DOF INDICES
   IdxVector inodes(nodeCount);
 
+  updateOutput_(disp);
+
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, false);
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, false, "output");
-
-    shapes = shapeK_->getShapeFunctions();
+    inodes = elemNodes_[ie];
 
     for (idx_t iNode = 0; iNode < nodeCount; iNode++)
     {
       for (idx_t ip = 0; ip < ipCount; ip++)
       {
-        energy_table.addValue(inodes[iNode], jCol, shapes(iNode, ip) * weights[ip] * material_->getDissipatedEnergy(ie, ip));
+        energy_table.addValue(inodes[iNode], jCol, shapes(iNode, ip) * refWeights_(ip, ie) * outDissEnergy_(ip, ie));
         table_weights[inodes[iNode]] = 1.;
       }
     }
@@ -1157,12 +1910,14 @@ void SpecialCosseratRodModel::getDissipatedEnergy_(XTable &energy_table, const V
 double SpecialCosseratRodModel::getDissipatedEnergy_(const Vector &disp) const
 {
   const idx_t elemCount = rodElems_.size();
-  const idx_t ipCount = shapeK_->ipointCount();
+  const idx_t ipCount = ipointCount_();
   const idx_t nodeCount = shapeK_->nodeCount();
   const idx_t rank = shapeK_->globalRank();
   const idx_t dofCount = dofs_->typeCount();
   double E_diss = 0.;
 
+  ElemWork_ &work = getElemWork_();
+
   // PER ELEMENT VALUES
   Matrix nodeU(rank, nodeCount);
   Matrix nodePhi_0(rank, nodeCount);
@@ -1170,19 +1925,15 @@ double SpecialCosseratRodModel::getDissipatedEnergy_(const Vector &disp) const
   Matrix strain(dofCount, ipCount);
   Matrix stress(dofCount, ipCount);
   Vector weights(ipCount);
-  Matrix shapes(shapeK_->shapeFuncCount(), ipCount);
-  // DOF INDICES
-  IdxVector inodes(nodeCount);
+  // all points, see getSkippedPart_
+  const Matrix shapes = ipShapes_;
 
   for (idx_t ie = 0; ie < elemCount; ie++)
   {
-    allElems_.getElemNodes(inodes, rodElems_.getIndex(ie));
-    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, inodes);
-
-    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, false);
-    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, false, "output");
+    getDisplacments_(nodePhi_0, nodeU, nodeLambda, disp, ie);
 
-    shapes = shapeK_->getShapeFunctions();
+    getStrains_(strain, weights, nodePhi_0, nodeU, nodeLambda, ie, work, false);
+    getStresses_(stress, weights, nodePhi_0, nodeU, nodeLambda, ie, work, false, "output");
 
     for (idx_t iNode = 0; iNode < nodeCount; iNode++)
     {
@@ -52,11 +52,16 @@
 #include <math.h>
 
 #include "misc/Line3D.h"
+#include "utils/batchSO3.h"
+#include "utils/fixedAlgebra.h"
 #include "utils/helpers.h"
+#include "utils/SolverNames.h"
+#include "utils/parallel.h"
 #include "utils/testing.h"
 
 using jem::Slice;
 using jem::SliceFrom;
+using jem::SliceTo;
 using jem::numeric::matmul;
 using jem::numeric::MatmulChain;
 using jem::numeric::norm2;
@@ -64,6 +69,7 @@ using jem::numeric::Quaternion;
 using jem::util::Properties;
 
 using jive::BoolVector;
+using jive::IdxMatrix;
 using jive::algebra::AbstractMatrix;
 using jive::algebra::FlexMBuilder;
 using jive::algebra::MatrixBuilder;
@@ -82,11 +88,23 @@ using jive::util::joinNames;
 using jive::util::XDofSpace;
 using jive::util::XTable;
 
+using jive_helpers::composeBatch;
 using jive_helpers::e3;
 using jive_helpers::expVec;
+using jive_helpers::expVecBatch;
 using jive_helpers::eye;
+using jive_helpers::load;
+using jive_helpers::Mat3;
+using jive_helpers::mat3Mul;
+using jive_helpers::mat3TMul;
+using jive_helpers::mat3TVec;
+using jive_helpers::mat3Vec;
+using jive_helpers::Mat6;
+using jive_helpers::pushForward;
 using jive_helpers::skew;
+using jive_helpers::store;
 using jive_helpers::unskew;
+using jive_helpers::Vec3;
 using jive_helpers::vec2mat;
 
 //-----------------------------------------------------------------------
@@ -111,6 +129,8 @@ using jive_helpers::vec2mat;
  * - Initial strain and rotation specification
  * - Energy calculation (potential and dissipated)
  * - Strain and stress output tables
+ * - Optional selective integration of the shear/axial terms
+ * - Optional matrix-free tangent operator for Krylov solvers (MatrixFreeNonlin)
  *
  * @see [Reissner (1981)](https://doi.org/10.1007/BF00946983)
  * @see [Simo, Vu-Quoc (1986)](https://doi.org/10.1016/0045-7825(86)90079-4)
@@ -134,6 +154,9 @@ public:
   static const char *GIVEN_DIRS;        ///< Given directions property
   static const char *LUMPED_MASS;       ///< Lumped mass property
   static const char *HINGES;            ///< Hinges property
+  static const char *THREAD_COUNT;      ///< Assembly thread count property
+  static const char *SHEAR_SHAPE;       ///< Shape for the shear/axial terms (selective integration)
+  static const char *MATRIX_FREE;       ///< Matrix-free tangent property
   /// @}
 
   /// @name DOF constants
@@ -180,6 +203,41 @@ public:
   static void declare();
 
 private:
+  /// @brief Work arrays of one element evaluation
+  /// @details One set per thread (see elemWork_), sized in initElemWork_,
+  /// so the element loops do not allocate them for every element
+  struct ElemWork_
+  {
+    Matrix nodeU;        ///< Translational displacements of the nodes
+    Matrix nodePhi_0;    ///< Reference positions of the nodes
+    Cubix nodeLambda;    ///< Rotations of the nodes
+    Cubix ipLambda;      ///< Rotations at the integration points
+    Cubix strainLambda;  ///< Rotations at the integration points (getStrains_, getStresses_)
+    Cubix strainLambdaP; ///< Rotation gradients at the integration points (getStrains_)
+    Matrix matStrains;   ///< Material strains at the integration points (getStresses_)
+    Matrix stress;       ///< Stresses at the integration points
+    Vector weights;      ///< Integration point weights
+    Quadix XI;           ///< XI operators at the integration points
+    Quadix XIK;          ///< XI operators of the full integration points (getXi_)
+    Quadix XIR;          ///< XI operators of the reduced integration points (getXi_)
+    Matrix spatialC;     ///< Spatial stiffness at one integration point
+    Cubix geomStiff;     ///< Geometric stiffness at the integration points
+    Matrix elemXI;       ///< XI operators of all nodes at one integration point
+    Vector elemX;        ///< Element part of a global vector
+    Vector ipStrain;     ///< Strains at one integration point
+    Vector ipStress;     ///< Stresses at one integration point
+    Vector psiX;         ///< Psi operator times a vector
+    Vector psiY;         ///< Geometric stiffness times psiX
+    Matrix B;            ///< Geometric stiffness at one integration point
+  };
+
+  /// @brief Size the work arrays of the element evaluations (one set per thread)
+  void initElemWork_();
+
+  /// @brief Get the work arrays of the calling thread
+  /// @return Work arrays, only used by the calling thread
+  inline ElemWork_ &getElemWork_() const;
+
   /// @brief Assemble stiffness matrix and internal forces
   /// @param mbld Tangent stiffness matrix builder
   /// @param fint Internal force vector
@@ -198,6 +256,72 @@ private:
                  const Vector &disp,
                  const String &loadCase = "") const;
 
+  /// @brief Evaluate the dense stiffness matrix and force vector of one element
+  /// @param elemK Element stiffness matrix (rows/columns as in elemDofs_)
+  /// @param elemF Element internal force vector (rows as in elemDofs_)
+  /// @param ie Element index
+  /// @param disp Current DOF values
+  /// @param loadCase Load case identifier
+  /// @param work Work arrays of the calling thread
+  /// @note Only writes to the given buffers and the material state of this
+  /// element, so different elements may be evaluated concurrently
+  void getElemContrib_(const Matrix &elemK,
+                       const Vector &elemF,
+                       const idx_t ie,
+                       const Vector &disp,
+                       const String &loadCase,
+                       ElemWork_ &work) const;
+
+  /// @brief Evaluate the internal force vector of one element
+  /// @param elemF Element internal force vector (rows as in elemDofs_)
+  /// @param ie Element index
+  /// @param disp Current DOF values
+  /// @param loadCase Load case identifier
+  /// @param work Work arrays of the calling thread
+  void getElemForce_(const Vector &elemF,
+                     const idx_t ie,
+                     const Vector &disp,
+                     const String &loadCase,
+                     ElemWork_ &work) const;
+
+  /// @brief Construct the internal force vector and store the linearization
+  /// point of the matrix-free tangent
+  /// @param fint Internal force vector
+  /// @param disp Current DOF values
+  /// @param loadCase Load case identifier
+  void assembleTangentState_(const Vector &fint,
+                             const Vector &disp,
+                             const String &loadCase);
+
+  /// @brief Evaluate the internal force vector of one element and store its
+  /// linearization point
+  /// @param elemF Element internal force vector (rows as in elemDofs_)
+  /// @param ie Element index
+  /// @param disp Current DOF values
+  /// @param loadCase Load case identifier
+  /// @param work Work arrays of the calling thread
+  void getElemTangentState_(const Vector &elemF,
+                            const idx_t ie,
+                            const Vector &disp,
+                            const String &loadCase,
+                            ElemWork_ &work);
+
+  /// @brief Multiply the stored tangent with a vector (matrix-free)
+  /// @param lhs Product of the tangent and rhs
+  /// @param rhs Vector to be multiplied
+  void applyTangent_(const Vector &lhs,
+                     const Vector &rhs) const;
+
+  /// @brief Multiply the stored tangent of one element with a vector
+  /// @param elemY Element product (rows as in elemDofs_)
+  /// @param elemX Element vector (rows as in elemDofs_)
+  /// @param ie Element index
+  /// @param work Work arrays of the calling thread
+  void applyElemTangent_(const Vector &elemY,
+                         const Vector &elemX,
+                         const idx_t ie,
+                         ElemWork_ &work) const;
+
   /// @brief Construct gyroscopic forces (omega x Theta*omega)
   /// @param fint Gyroscopic force vector
   /// @param velo Current DOF velocities
@@ -212,6 +336,14 @@ private:
   void assembleM_(MatrixBuilder &mbld,
                   Vector &disp) const;
 
+  /// @brief Estimate the critical time step of explicit time integration
+  /// @details Bounds the largest eigenfrequency of every element by its
+  /// axial, shear, torsional and bending stiffness with a Gershgorin bound
+  /// of the element stiffness against the lumped nodal masses, which also
+  /// covers higher order elements, dt = 2 / omega_max
+  /// @return smallest critical time step over all elements
+  double getStableStep_() const;
+
   /// @brief Fill table with strain values per element
   /// @param strain_table Output strain table
   /// @param weights Table weights
@@ -244,6 +376,59 @@ private:
                        const Vector &disp,
                        const bool mat_vals = false);
 
+  /// @brief Evaluate all output quantities of the rod in one pass
+  /// @param disp Current displacements
+  /// @note Strains, stresses (material and spatial) and energies are
+  /// evaluated once per state and shared by all output tables
+  void updateOutput_(const Vector &disp);
+
+  /// @brief Get the number of material integration points per element
+  /// @return Points of the stiffness shape plus those of the shear shape
+  /// @note With selective integration the points of the stiffness shape
+  /// come first, followed by the points of the shear shape
+  idx_t ipointCount_() const;
+
+  /// @brief Get the stress components not integrated at a point
+  /// @param ip Integration point index
+  /// @return TRANS_PART at the stiffness points, ROT_PART at the shear points
+  /// @note Only meaningful with selective integration. These strain
+  /// components are not passed to the material either, so the energies are
+  /// integrated over all points, each with the terms of its own scheme
+  Slice getSkippedPart_(const idx_t ip) const;
+
+  /// @brief Get the rotations at all integration points of an element
+  /// @param ipLambda Rotations at the integration points
+  /// @param nodeLambda Rotations at the nodes
+  void getIpRotations_(const Cubix &ipLambda,
+                       const Cubix &nodeLambda) const;
+
+  /// @brief Get the XI operators at all integration points of an element
+  /// @param work Work arrays with the node positions and displacements,
+  /// the operators are stored in work.XI
+  /// @param ie Element index
+  void getXi_(ElemWork_ &work,
+              const idx_t ie) const;
+
+  /// @brief Evaluate the output quantities of one element
+  /// @param ie Element index
+  /// @param disp Current displacements
+  /// @param work Work arrays of the calling thread
+  /// @note Only writes to the output values and the material state of this
+  /// element, so different elements may be evaluated concurrently
+  void getElemOutput_(const idx_t ie,
+                      const Vector &disp,
+                      ElemWork_ &work);
+
+  /// @brief Build the element connectivity and DOF index tables
+  void initDofTables_();
+
+  /// @brief Mark the DOF index tables as outdated (DofSpace changed)
+  void invalidateDofTables_();
+
+  /// @brief Build the reference geometry (coordinates, shape gradients,
+  /// integration weights and Psi operators) of all elements
+  void initRefGeometry_();
+
   /// @brief Initialize rotation of elements
   void initRotation_();
 
@@ -255,10 +440,20 @@ private:
   /// @param stresses Spatial stress components at integration points
   /// @param nodePhi_0 Location of the nodes
   /// @param nodeU Translational displacement of nodes
+  /// @param ie Element index
   void getGeomtericStiffness_(const Cubix &B,
                               const Matrix &stresses,
                               const Matrix &nodePhi_0,
-                              const Matrix &nodeU) const;
+                              const Matrix &nodeU,
+                              const idx_t ie) const;
+
+  /// @brief Get the geometric stiffness matrix at one integration point
+  /// @param B B-matrix at the integration point
+  /// @param stress Spatial stress components at the integration point
+  /// @param phiP Derivative of the centerline at the integration point
+  void getGeomStiffAt_(const Matrix &B,
+                       const Vector &stress,
+                       const Vec3 &phiP) const;
 
   /// @brief Get the strains in the integration points of an element
   /// @param strains Strain components at integration points
@@ -267,6 +462,7 @@ private:
   /// @param nodeU Translational displacement of nodes
   /// @param nodeLambda Rotational orientation of nodes
   /// @param ie Element index
+  /// @param work Work arrays of the calling thread
   /// @param spatial use inertial frame of reference (true) or spatial frame of reference (false)
   void getStrains_(const Matrix &strains,
                    const Vector &w,
@@ -274,6 +470,7 @@ private:
                    const Matrix &nodeU,
                    const Cubix &nodeLambda,
                    const idx_t ie,
+                   ElemWork_ &work,
                    const bool spatial = true) const;
 
   /// @brief Get the stresses in the integration points of an element
@@ -283,6 +480,7 @@ private:
   /// @param nodeU Translational displacement of nodes
   /// @param nodeLambda Rotational orientation of nodes
   /// @param ie Element index
+  /// @param work Work arrays of the calling thread
   /// @param spatial use inertial frame of reference (true) or spatial frame of reference (false)
   /// @param loadCase Load case identifier
   void getStresses_(const Matrix &stresses,
@@ -291,6 +489,7 @@ private:
                     const Matrix &nodeU,
                     const Cubix &nodeLambda,
                     const idx_t ie,
+                    ElemWork_ &work,
                     const bool spatial = true,
                     const String &loadCase = "") const;
 
@@ -299,12 +498,19 @@ private:
   /// @param nodeU Node displacements
   /// @param nodeLambda Node rotations
   /// @param disp Displacement vector
-  /// @param inodes Node indices
+  /// @param ie Element index
   void getDisplacments_(const Matrix &nodePhi_0,
                         const Matrix &nodeU,
                         const Cubix &nodeLambda,
                         const Vector &disp,
-                        const IdxVector &inodes) const;
+                        const idx_t ie) const;
+
+  /// @brief Update the cached rotations of all rod nodes
+  /// @param disp Displacement vector
+  /// @note The rotations are evaluated for all nodes at once. Force
+  /// evaluations, COMMIT, ADVANCE and CANCEL invalidate them, so tables and
+  /// masses of the committed state reuse the rotations of COMMIT
+  void updateNodeRotations_(const Vector &disp);
 
   /// @brief Calculate potential energy of the rod
   /// @param disp Displacement vector
@@ -317,7 +523,7 @@ private:
   /// @param disp Displacement vector
   void getPotentialEnergy_(XTable &energy_table,
                            const Vector &table_weights,
-                           const Vector &disp) const;
+                           const Vector &disp);
 
   /// @brief Calculate dissipated energy of the material
   /// @param disp Displacement vector
@@ -330,7 +536,9 @@ private:
   /// @param disp Displacement vector
   void getDissipatedEnergy_(XTable &energy_table,
                             const Vector &table_weights,
-                            const Vector &disp) const;
+                            const Vector &disp);
+
+  class TangentOperator_;
 
 private:
   Assignable<ElementGroup> rodElems_; ///< Rod element group
@@ -341,6 +549,7 @@ private:
   Ref<DofSpace> dofs_;     ///< DOF space
   Ref<Line3D> shapeK_;     ///< Shape functions for stiffness
   Ref<Line3D> shapeM_;     ///< Shape functions for mass
+  Ref<Line3D> shapeR_;     ///< Shape functions for the shear/axial terms (selective integration only)
   Ref<Material> material_; ///< Material model
   Ref<Model> hinges_;      ///< Hinge model
 
@@ -348,7 +557,21 @@ private:
   IdxVector rotTypes_;   ///< Rotational DOF types
   IdxVector jtypes_;     ///< Joint DOF types
 
+  IdxMatrix elemNodes_;  ///< Global node indices per element (node x element)
+  IdxMatrix elemDofs_;   ///< DOF indices per element (node-wise jtypes_ x element)
+  IdxMatrix nodeDofs_;   ///< DOF indices per rod node (jtypes_ x local rod node)
+  bool dofTablesValid_;  ///< Whether the index tables match the DofSpace
+
+  Cubix refCoords_;        ///< Reference node coordinates per element (rank x node x element)
+  Cubix refGrads_;         ///< Shape function gradients per element (node x ip x element)
+  Matrix refWeights_;      ///< Integration weights per element (ip x element)
+  Matrix refMassWeights_;  ///< Integration weights of the mass shape per element (ip x element)
+  Quadix refPsi_;          ///< Stacked Psi operators per element (node-wise jtypes_ x 9 x ip x element)
+  Matrix ipShapes_;        ///< Shape functions at all integration points (node x ip)
+
   bool symOnly_;        ///< Symmetric tangent stiffness flag
+  bool matrixFree_;     ///< Matrix-free tangent flag
+  idx_t threadCount_;   ///< Number of threads for the element loops
   Vector thickFact_;    ///< Thickening factors
   Vector materialYDir_; ///< Material y-direction
 
@@ -356,5 +579,35 @@ private:
   Matrix givenDirs_;     ///< Given directions for nodes
 
   Cubix LambdaN_;    ///< Reference rotations per node
+  Matrix refRots_;   ///< Reference rotations per node (rod node x 9)
+  Matrix nodeRots_;  ///< Current rotations per node (rod node x 9)
+  Matrix rotVecs_;   ///< Rotational DOFs per node (rod node x 3, work)
+  Matrix rotExp_;    ///< Incremental rotations per node (rod node x 9, work)
+  bool rotCacheValid_; ///< Whether nodeRots_ belongs to the current state
   Cubix matStrain0_; ///< Initial strain configuration
+
+  Cubix outStrain_;      ///< Spatial strains of the output state (dof x ip x element)
+  Cubix outMatStrain_;   ///< Material strains of the output state (dof x ip x element)
+  Cubix outStress_;      ///< Spatial stresses of the output state (dof x ip x element)
+  Cubix outMatStress_;   ///< Material stresses of the output state (dof x ip x element)
+  Matrix outPotEnergy_;  ///< Potential energy density of the output state (ip x element)
+  Matrix outDissEnergy_; ///< Dissipated energy density of the output state (ip x element)
+  Vector outDisp_;       ///< Displacements belonging to the output values
+  bool outputValid_;     ///< Whether the output values belong to outDisp_
+
+  Ref<AbstractMatrix> tangent_; ///< Matrix-free tangent operator
+  Cubix tanPhiP_;   ///< Centerline derivatives of the linearization point (3 x ip x element)
+  Cubix tanStress_; ///< Integrated spatial stresses of the linearization point (dof x ip x element)
+  Quadix tanC_;     ///< Integrated spatial stiffness of the linearization point (dof x dof x ip x element)
+
+  mutable jem::Array<ElemWork_> elemWork_; ///< Work arrays of the element evaluations (one set per thread)
 };
+
+//-----------------------------------------------------------------------
+//   getElemWork_
+//-----------------------------------------------------------------------
+
+inline SpecialCosseratRodModel::ElemWork_ &SpecialCosseratRodModel::getElemWork_() const
+{
+  return elemWork_[jive_helpers::threadIndex()];
+}
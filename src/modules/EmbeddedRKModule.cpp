@@ -32,6 +32,7 @@ EmbeddedRKModule::EmbeddedRKModule
       Super(name)
 
 {
+  butchSize_ = 0;
 }
 
 EmbeddedRKModule::~EmbeddedRKModule()
@@ -64,6 +65,9 @@ Module::Status EmbeddedRKModule::init
     throw jem::IllegalInputException(
         "Unkown kind of embedded RK method!");
 
+  // the stage tables depend on the tableau size
+  initWork_();
+
   return Status::OK;
 }
 
@@ -154,32 +158,18 @@ void EmbeddedRKModule::solve
     (const Properties &info, const Properties &globdat)
 
 {
-  const idx_t dofCount = dofs_->dofCount();
   double error;
   double t_cur;
-  Vector u_cur(dofCount);
-  Vector v_cur(dofCount);
-  Vector a_cur(dofCount);
-  Vector du(dofCount);
-  Vector dv(dofCount);
   double t_step;
-  Vector u_step(dofCount);
-  Vector v_step(dofCount);
-  Vector a_step(dofCount);
-  Vector fres(dofCount);
-  Vector fint(dofCount);
-  Vector fext(dofCount);
-  Matrix ku_tab(dofCount, butchSize_);
-  Matrix kv_tab(dofCount, butchSize_);
-  Vector u_new(dofCount);
-  Vector v_new(dofCount);
-  Vector a_new(dofCount);
-
-  // get the current vectors
-  StateVector::get(u_cur, jive::model::STATE0, dofs_, globdat);
-  StateVector::get(v_cur, jive::model::STATE1, dofs_, globdat);
-  fres = getForce(fint, fext, globdat);
-  getAcce(a_cur, cons_, fres, globdat);
+  Vector u_state, v_state;
+
+  // get the current vectors (copies, the state is overwritten below)
+  StateVector::get(u_state, jive::model::STATE0, dofs_, globdat);
+  StateVector::get(v_state, jive::model::STATE1, dofs_, globdat);
+  uCur_ = u_state;
+  vCur_ = v_state;
+  getForce(fres_, globdat);
+  getAcce(aCur_, cons_, fres_, globdat);
   globdat.get(t_cur, Globdat::TIME);
 
   /////////////////////////////////////////////////
@@ -191,30 +181,30 @@ void EmbeddedRKModule::solve
         << "\n ...Runge Kutta Level " << i + 1 << "\n";
 
     // get the updates (U_j in RKMK reference)
-    dv = dtime_ * a_cur;
+    dv_ = dtime_ * aCur_;
     for (idx_t j = 0; j < i; j++)
-      dv += a_(i, j) * kv_tab[j];
-    du = dtime_ * v_cur;
+      dv_ += a_(i, j) * kvTab_[j];
+    du_ = dtime_ * vCur_;
     for (idx_t j = 0; j < i; j++)
-      du += a_(i, j) * ku_tab[j];
+      du_ += a_(i, j) * kuTab_[j];
 
     // use the updates to compute new functions
-    updateVec(v_step, v_cur, dv);
-    updateVec(u_step, u_cur, du, true);
+    updateVec(vStep_, vCur_, dv_);
+    updateVec(uStep_, uCur_, du_, true);
     t_step = t_cur + c_[i] * dtime_;
 
-    StateVector::store(u_step, jive::model::STATE0, dofs_, globdat);
-    StateVector::store(v_step, jive::model::STATE1, dofs_, globdat);
+    StateVector::store(uStep_, jive::model::STATE0, dofs_, globdat);
+    StateVector::store(vStep_, jive::model::STATE1, dofs_, globdat);
     globdat.set(Globdat::TIME, t_step);
 
-    fres = getForce(fint, fext, globdat);
-    getAcce(a_step, cons_, fres, globdat);
+    getForce(fres_, globdat);
+    getAcce(aStep_, cons_, fres_, globdat);
 
     // compute the k - values (F_j in the reference)
-    kv_tab[i] = dtime_ * a_step;
-    ku_tab[i] = dtime_ * v_step;
+    kvTab_[i] = dtime_ * aStep_;
+    kuTab_[i] = dtime_ * vStep_;
     // correct the displacements (K_j in the reference)
-    correctDisp_(ku_tab[i], du);
+    correctDisp_(kuTab_[i], du_);
   }
 
   jem::System::info(myName_) << "\n ...Runge Kutta Advancement\n";
@@ -224,8 +214,8 @@ void EmbeddedRKModule::solve
   /////////////////////////////////////////////////
   if (fsal_)
   {
-    u_new = u_step;
-    v_new = v_step;
+    uNew_ = uStep_;
+    vNew_ = vStep_;
   }
   else
     NOT_IMPLEMENTED
@@ -236,28 +226,45 @@ void EmbeddedRKModule::solve
   // compute the values at the current step
 
   // get the updates (U_j in RKMK reference)
-  dv = dtime_ * a_cur;
+  dv_ = dtime_ * aCur_;
   for (idx_t j = 0; j < butchSize_; j++)
-    dv += b_[j] * kv_tab[j];
-  du = dtime_ * v_cur;
+    dv_ += b_[j] * kvTab_[j];
+  du_ = dtime_ * vCur_;
   for (idx_t j = 0; j < butchSize_; j++)
-    du += b_[j] * ku_tab[j];
+    du_ += b_[j] * kuTab_[j];
 
   // use the updates to compute new functions
-  updateVec(v_step, v_cur, dv);
-  updateVec(u_step, u_cur, du, true);
+  updateVec(vStep_, vCur_, dv_);
+  updateVec(uStep_, uCur_, du_, true);
 
   /////////////////////////////////////////////////
   ////////  step size adaption
   /////////////////////////////////////////////////
   error = 0.;
-  error += getQuality(u_step, u_new);
-  error += getQuality(v_step, v_new) * dtime_;
+  error += getQuality(uStep_, uNew_);
+  error += getQuality(vStep_, vNew_) * dtime_;
 
   info.set(SolverInfo::RESIDUAL, error);
 
-  StateVector::store(u_new, jive::model::STATE0, dofs_, globdat);
-  StateVector::store(v_new, jive::model::STATE1, dofs_, globdat);
+  StateVector::store(uNew_, jive::model::STATE0, dofs_, globdat);
+  StateVector::store(vNew_, jive::model::STATE1, dofs_, globdat);
+}
+
+//-----------------------------------------------------------------------
+//   initWork_
+//-----------------------------------------------------------------------
+
+void EmbeddedRKModule::initWork_()
+{
+  const idx_t dofCount = dofs_->dofCount();
+
+  Super::initWork_();
+
+  resizeWork_(uStep_, dofCount);
+  resizeWork_(vStep_, dofCount);
+  resizeWork_(aStep_, dofCount);
+  resizeWork_(kuTab_, dofCount, butchSize_);
+  resizeWork_(kvTab_, dofCount, butchSize_);
 }
 
 // correct the caluclated function results
@@ -266,45 +273,64 @@ void EmbeddedRKModule::solve
 void EmbeddedRKModule::correctDisp_(const Vector &uncorrected,
                                     const Vector &delta)
 {
-  const idx_t rotCount = rdofs_.size(0);
   const idx_t nodeCount = rdofs_.size(1);
 
-  Vector localu(rotCount);
-  Vector localf(rotCount);
-  Vector localk(rotCount);
-  Matrix localU(rotCount, rotCount);
-  Matrix localF(rotCount, rotCount);
-  Matrix localK(rotCount, rotCount);
+  Vec3 localu;
+  Vec3 localf;
+  Vec3 localk;
+  Mat3 localU;
+  Mat3 localF;
+  Mat3 localK;
 
   for (idx_t inode = 0; inode < nodeCount; inode++)
   {
-    localf = uncorrected[rdofs_[inode]];
-    if (jem::isTiny(norm2(localf)))
+    for (idx_t i = 0; i < 3; i++)
+      localf[i] = uncorrected[rdofs_(i, inode)];
+    if (jem::isTiny(jive_helpers::vec3Norm(localf)))
       continue; // prevent numerical issues with small numbers
-    localu = delta[rdofs_[inode]];
+    for (idx_t i = 0; i < 3; i++)
+      localu[i] = delta[rdofs_(i, inode)];
 
-    localU = jive_helpers::skew(localu);
-    localF = jive_helpers::skew(localf);
+    jive_helpers::skew(localU, localu);
+    jive_helpers::skew(localF, localf);
 
     invDerivExpMap_(localK, localF, localU);
 
-    localk = jive_helpers::unskew(localK);
+    jive_helpers::unskew(localk, localK);
 
-    uncorrected[rdofs_[inode]] = localk;
+    for (idx_t i = 0; i < 3; i++)
+      uncorrected[rdofs_(i, inode)] = localk[i];
   }
 }
 
 // compute the inverse of the Darboux derivative of the exponential map
 // (see
 // https://link.springer.com/referenceworkentry/10.1007/978-3-540-70529-1_122#Sec1139)
-void EmbeddedRKModule::invDerivExpMap_(const Matrix &res,
-                                       const Matrix &point,
-                                       const Matrix &about)
+void EmbeddedRKModule::invDerivExpMap_(Mat3 &res,
+                                       const Mat3 &point,
+                                       const Mat3 &about)
 {
-  res = 0.;
+  Mat3 term = point;
+  Mat3 next;
+
+  for (int j = 0; j < 3; j++)
+    for (int k = 0; k < 3; k++)
+      res(k, j) = 0.;
 
   for (idx_t i = 0; i < order_; i++)
-    res += bernoulliCoeff_(i) * adjoint_(point, about, i);
+  {
+    // the i-th iterated adjoint follows from the previous one
+    if (i > 0)
+    {
+      adjoint_(next, term, about);
+      term = next;
+    }
+
+    const double coeff = bernoulliCoeff_(i);
+    for (int j = 0; j < 3; j++)
+      for (int k = 0; k < 3; k++)
+        res(k, j) += coeff * term(k, j);
+  }
 }
 
 double EmbeddedRKModule::bernoulliCoeff_(const idx_t i)
@@ -337,20 +363,19 @@ double EmbeddedRKModule::bernoulliCoeff_(const idx_t i)
     throw jem::Exception("We do not dare to go this high!");
   }
 }
-Matrix EmbeddedRKModule::adjoint_(const Matrix &point,
-                                  const Matrix &about,
-                                  const idx_t iterate)
+void EmbeddedRKModule::adjoint_(Mat3 &res,
+                                const Mat3 &point,
+                                const Mat3 &about)
 {
-  JEM_ASSERT(iterate >= 0);
+  Mat3 left;
+  Mat3 right;
 
-  if (iterate == 0)
-    return point;
-  else
-  {
-    Matrix res = adjoint_(point, about, iterate - 1);
-    res = matmul(about, res) - matmul(res, about);
-    return res;
-  }
+  jive_helpers::mat3Mul(left, about, point);
+  jive_helpers::mat3Mul(right, point, about);
+
+  for (int j = 0; j < 3; j++)
+    for (int i = 0; i < 3; i++)
+      res(i, j) = left(i, j) - right(i, j);
 }
 
 //-----------------------------------------------------------------------
@@ -12,8 +12,12 @@
 #pragma once
 
 #include "modules/ExplicitModule.h"
+#include "utils/fixedAlgebra.h"
 #include <jem/base/Class.h>
 
+using jive_helpers::Mat3;
+using jive_helpers::Vec3;
+
 /// @brief Module for embedded Runge-Kutta time integration methods
 /// @details Implements embedded Runge-Kutta schemes including Bogacki-Shampine (ODE23)
 /// and Dormand-Prince (ODE45) methods with adaptive step size control. Features
@@ -91,22 +95,25 @@ private:
   /// @return Bernoulli coefficient value
   double bernoulliCoeff_(const idx_t i);
 
-  /// @brief Compute adjoint operator for Lie group integration
+  /// @brief Compute the adjoint operator for Lie group integration
+  /// @param res Commutator [about, point] (output, must not alias the inputs)
   /// @param point Current point on manifold
   /// @param about Reference point
-  /// @param iterate Iteration number
-  /// @return Adjoint matrix
-  Matrix adjoint_(const Matrix &point,
-                  const Matrix &about,
-                  const idx_t iterate);
+  /// @details Applied repeatedly, this gives the iterated adjoints
+  void adjoint_(Mat3 &res,
+                const Mat3 &point,
+                const Mat3 &about);
 
   /// @brief Compute inverse derivative of exponential map
   /// @param res Result matrix (output)
   /// @param point Current point
   /// @param about Reference point
-  void invDerivExpMap_(const Matrix &res,
-                       const Matrix &point,
-                       const Matrix &about);
+  void invDerivExpMap_(Mat3 &res,
+                       const Mat3 &point,
+                       const Mat3 &about);
+
+  /// @brief Size the stage work arrays in addition to the base ones
+  virtual void initWork_() override;
 
 private:
   /// @name Runge-Kutta parameters
@@ -119,4 +126,13 @@ private:
   bool fsal_;       ///< First Same As Last property
   Vector c_;        ///< Butcher tableau c vector
   /// @}
+
+  /// @name Stage work arrays
+  /// @{
+  Vector uStep_; ///< Stage displacements
+  Vector vStep_; ///< Stage velocities
+  Vector aStep_; ///< Stage accelerations
+  Matrix kuTab_; ///< Displacement stage increments (one column per stage)
+  Matrix kvTab_; ///< Velocity stage increments (one column per stage)
+  /// @}
 };
@@ -6,9 +6,12 @@
  */
 
 #include "modules/ExplicitModule.h"
+#include "utils/SolverNames.h"
 #include "utils/testing.h"
 
 #include <jem/base/ClassTemplate.h>
+#include <jem/base/Float.h>
+#include <jem/base/IllegalInputException.h>
 
 //=======================================================================
 //   class ExplicitModule
@@ -24,6 +27,9 @@ const char *ExplicitModule::TYPE_NAME = "Explicit";
 const char *ExplicitModule::STEP_COUNT = "stepCount";
 const char *ExplicitModule::SO3_DOFS = "dofs_SO3";
 const char *ExplicitModule::LEN_SCALE = "lengthScale";
+const char *ExplicitModule::STABLE_FACTOR = "stableStepFactor";
+const char *ExplicitModule::BATCH_STEPS = "batchSteps";
+const char *ExplicitModule::BATCH_BREAK = "batchBreak";
 
 //-----------------------------------------------------------------------
 //   constructor & destructor
@@ -44,7 +50,13 @@ ExplicitModule::ExplicitModule
   saftey_ = 0.9;
   decrFact_ = 0.8;
   incrFact_ = 1.2;
+  stableFact_ = 0.;
+  stableDtime_ = jem::Float::MAX_VALUE;
+  maxStepLevel_ = 0;
+  stepLevel_ = 0;
+  batchSteps_ = 1;
   order_ = 0;
+  dofsValid_ = false;
 }
 
 ExplicitModule::~ExplicitModule()
@@ -125,6 +137,24 @@ Module::Status ExplicitModule::init
     updCond_ = FuncUtils::newCond(true);
   FuncUtils::getConfig(myConf, updCond_, PropNames::UPDATE_COND);
 
+  // Initialize step batching
+  myProps.find(batchSteps_, BATCH_STEPS, 1, jem::maxOf(batchSteps_));
+  myConf.set(BATCH_STEPS, batchSteps_);
+
+  if (myProps.contains(BATCH_BREAK))
+    FuncUtils::configCond(batchBreak_, BATCH_BREAK, myProps, globdat);
+  else
+  {
+    batchBreak_ = FuncUtils::newCond(false);
+
+    // the other modules only run between batches
+    if (batchSteps_ > 1)
+      jem::System::warn() << myName_ << " ...No " << BATCH_BREAK << " condition given, "
+                          << "control and output conditions are only checked every "
+                          << batchSteps_ << " steps\n";
+  }
+  FuncUtils::getConfig(myConf, batchBreak_, BATCH_BREAK);
+
   // time stepping settings
   myProps.find(prec_, PropNames::PRECISION);
   myConf.set(PropNames::PRECISION, prec_);
@@ -146,6 +176,8 @@ Module::Status ExplicitModule::init
   myConf.set("increaseFactor", incrFact_);
   myProps.find(decrFact_, "decreaseFactor", 1., 2.);
   myConf.set("decreaseFactor", decrFact_);
+  myProps.find(stableFact_, STABLE_FACTOR, 0., 1.);
+  myConf.set(STABLE_FACTOR, stableFact_);
 
   // Initialize solver
   jive::solver::declareSolvers();
@@ -207,6 +239,7 @@ void ExplicitModule::shutdown(const Properties &globdat)
   solver_ = nullptr;
   dofs_ = nullptr;
   updCond_ = nullptr;
+  batchBreak_ = nullptr;
 }
 
 //-----------------------------------------------------------------------
@@ -231,6 +264,9 @@ void ExplicitModule::configure
 
   maxDtime_ = dtime_ * 1000.;
   myProps.find(maxDtime_, PropNames::MAX_DTIME, dtime_, NAN);
+
+  myProps.find(stableFact_, STABLE_FACTOR, 0., 1.);
+  myProps.find(batchSteps_, BATCH_STEPS, 1, jem::maxOf(batchSteps_));
 }
 
 //-----------------------------------------------------------------------
@@ -251,6 +287,58 @@ void ExplicitModule::getConfig
   myConf.set(PropNames::DELTA_TIME, dtime_);
   myConf.set(PropNames::MIN_DTIME, minDtime_);
   myConf.set(PropNames::MAX_DTIME, maxDtime_);
+  myConf.set(STABLE_FACTOR, stableFact_);
+  myConf.set(BATCH_STEPS, batchSteps_);
+}
+
+//-----------------------------------------------------------------------
+//   run
+//-----------------------------------------------------------------------
+
+Module::Status ExplicitModule::run(const Properties &globdat)
+{
+  if (batchSteps_ == 1)
+    return Super::run(globdat);
+
+  Properties info = SolverInfo::get(globdat);
+  idx_t stepCount = 0;
+  idx_t rejectCount = 0;
+
+  // every inner step is committed on its own, so the batch can stop after
+  // any of them with a consistent state
+  while (stepCount < batchSteps_)
+  {
+    info.clear();
+    advance(globdat);
+
+    try
+    {
+      solve(info, globdat);
+    }
+    catch (...)
+    {
+      cancel(globdat);
+      throw;
+    }
+
+    if (!commit(globdat))
+    {
+      cancel(globdat);
+      rejectCount++;
+      continue;
+    }
+
+    stepCount++;
+
+    if (FuncUtils::evalCond(*batchBreak_, globdat))
+      break;
+  }
+
+  jem::System::info(myName_)
+      << " ...Performed " << stepCount << " steps (" << rejectCount
+      << " rejected), time step size " << dtime_ << "\n";
+
+  return OK;
 }
 
 //-----------------------------------------------------------------------
@@ -258,8 +346,6 @@ void ExplicitModule::getConfig
 //-----------------------------------------------------------------------
 void ExplicitModule::advance(const Properties &globdat)
 {
-  Properties params;
-
   // check if mass needs to be updated
   valid_ = valid_ && !FuncUtils::evalCond(*updCond_, globdat);
   if (!valid_)
@@ -268,7 +354,8 @@ void ExplicitModule::advance(const Properties &globdat)
   // update time in models and boundary conditions
   Globdat::advanceTime(dtime_, globdat);
   Globdat::advanceStep(globdat);
-  model_->takeAction(Actions::ADVANCE, params, globdat);
+  stepParams_.clear();
+  model_->takeAction(Actions::ADVANCE, stepParams_, globdat);
 }
 
 //-----------------------------------------------------------------------
@@ -276,13 +363,12 @@ void ExplicitModule::advance(const Properties &globdat)
 //-----------------------------------------------------------------------
 void ExplicitModule::cancel(const Properties &globdat)
 {
-  Properties params;
-
   // update time in models and boundary conditions
   Globdat::restoreTime(globdat);
   Globdat::restoreStep(globdat);
   StateVector::restoreNew(dofs_, globdat);
-  model_->takeAction(Actions::CANCEL, params, globdat);
+  stepParams_.clear();
+  model_->takeAction(Actions::CANCEL, stepParams_, globdat);
 }
 
 //-----------------------------------------------------------------------
@@ -291,19 +377,25 @@ void ExplicitModule::cancel(const Properties &globdat)
 bool ExplicitModule::commit(const Properties &globdat)
 {
   double error;
-  Properties params;
   bool accept;
+  bool modelAccept;
 
   SolverInfo::get(globdat).get(error, SolverInfo::RESIDUAL);
 
   double dtime_opt = dtime_ * pow(prec_ / error, 1. / (static_cast<double>(order_) + 1.));
 
-  accept = true;
-  if (model_->takeAction(Actions::CHECK_COMMIT, params, globdat))
+  modelAccept = true;
+  stepParams_.clear();
+  if (model_->takeAction(Actions::CHECK_COMMIT, stepParams_, globdat))
   {
-    params.find(accept, ActionParams::ACCEPT);
+    stepParams_.find(modelAccept, ActionParams::ACCEPT);
   }
-  accept = accept && (error <= prec_ || dtime_ <= minDtime_);
+  if (!modelAccept && dtime_ <= minDtime_)
+  {
+    jem::System::warn() << myName_ << " ...Step rejected by the model at the smallest time step, accepting anyway\n";
+    modelAccept = true;
+  }
+  accept = modelAccept && (error <= prec_ || dtime_ <= minDtime_);
 
   if (accept)
   {
@@ -311,22 +403,36 @@ bool ExplicitModule::commit(const Properties &globdat)
         jem::max(jem::min(saftey_ * dtime_opt, incrFact_ * dtime_, maxDtime_),
                  decrFact_ * dtime_,
                  minDtime_);
-    params.clear();
-    model_->takeAction(Actions::COMMIT, params, globdat);
+    stepParams_.clear();
+    model_->takeAction(Actions::COMMIT, stepParams_, globdat);
     Globdat::commitStep(globdat);
     Globdat::commitTime(globdat);
     StateVector::updateOld(dofs_, globdat);
   }
+  else if (!modelAccept)
+  {
+    // e.g. contact events: the error estimate does not see them
+    dtime_ = jem::max(decrFact_ * dtime_, minDtime_);
+  }
   else
   {
     dtime_ = jem::max(saftey_ * dtime_opt, decrFact_ * dtime_, minDtime_);
   }
 
-  jem::System::info(myName_) << " ...Adapting time step size to " << dtime_ << "\n";
-  if (dtime_ >= maxDtime_ && dtime_ > minDtime_)
-    jem::System::info(myName_) << " !!! Largest allowed time step !!!\n";
-  if (dtime_ <= minDtime_ && dtime_ < maxDtime_)
-    jem::System::info(myName_) << " !!! Smallest allowed time step !!!\n";
+  // never exceed the stable time step
+  dtime_ = jem::max(jem::min(dtime_, stableDtime_), minDtime_);
+
+  // batched steps are only reported at the end of the batch
+  if (batchSteps_ == 1)
+  {
+    jem::System::info(myName_) << " ...Adapting time step size to " << dtime_ << "\n";
+    if (dtime_ >= stableDtime_)
+      jem::System::info(myName_) << " !!! Largest stable time step !!!\n";
+    if (dtime_ >= maxDtime_ && dtime_ > minDtime_)
+      jem::System::info(myName_) << " !!! Largest allowed time step !!!\n";
+    if (dtime_ <= minDtime_ && dtime_ < maxDtime_)
+      jem::System::info(myName_) << " !!! Smallest allowed time step !!!\n";
+  }
   Globdat::getVariables(globdat).set(jive::implict::PropNames::DELTA_TIME,
                                      dtime_);
 
@@ -366,56 +472,53 @@ void ExplicitModule::updateVec(const Vector &y_new,
 {
   y_new = y_old + delta_y;
 
-  if (rot)
+  if (rot && dofsSO3_.size())
   {
     const idx_t rotCount = dofsSO3_.size();
-    Vector r_node(rotCount);
-    Vector d_r(rotCount);
-    Matrix R_old(rotCount, rotCount);
-    Matrix R_new(rotCount, rotCount);
-    Matrix V_upd(rotCount, rotCount);
+    const idx_t nodeCount = rdofs_.size(1);
 
-    for (idx_t inode = 0; inode < rdofs_.size(1); inode++)
-    {
-      r_node = y_old[rdofs_[inode]];
-      d_r = delta_y[rdofs_[inode]];
+    JEM_ASSERT2(rotNode_.size(0) == nodeCount,
+                "work arrays do not match the dof space");
 
-      expVec(R_old, r_node);
-      expVec(V_upd, d_r);
-      matmul(R_new, V_upd, R_old);
+    // structure-of-arrays layout (one node per row)
+    for (idx_t i = 0; i < rotCount; i++)
+    {
+      rotNode_[i] = y_old[rdofs_(i, ALL)];
+      rotDelta_[i] = delta_y[rdofs_(i, ALL)];
+    }
 
-      logMat(r_node, R_new);
+    expVecBatch(rotOld_, rotNode_);
+    expVecBatch(rotUpd_, rotDelta_);
+    composeBatch(rotNew_, rotUpd_, rotOld_);
+    logMatBatch(rotNode_, rotNew_);
 
-      y_new[rdofs_[inode]] = r_node;
-    }
+    for (idx_t i = 0; i < rotCount; i++)
+      y_new[rdofs_(i, ALL)] = rotNode_[i];
   }
 }
 
 //-----------------------------------------------------------------------
 //   getForce
 //-----------------------------------------------------------------------
-Vector
-ExplicitModule::getForce(const Vector &fint,
-                         const Vector &fext,
-                         const Properties &globdat)
+void ExplicitModule::getForce(const Vector &fres,
+                              const Properties &globdat,
+                              const idx_t level)
 {
-  Properties params;
+  JEM_ASSERT2(level < forceParams_.size() - 1,
+              "subcycling level without action parameters");
 
-  // Get the internal and external force vectors for this configuration
-  fext = 0.0;
-  fint = 0.0;
+  // the parameters refer to fint_ and fext_ (see initParams_)
+  const Properties &params = forceParams_[level + 1];
 
-  params.set(ActionParams::EXT_VECTOR, fext);
-  params.set(ActionParams::INT_VECTOR, fint);
-  params.set(ActionParams::CONSTRAINTS, cons_);
-  if (mode_ == CONSISTENT)
-    params.set(ActionParams::MATRIX2, solver_->getMatrix());
+  // Get the internal and external force vectors for this configuration
+  fext_ = 0.0;
+  fint_ = 0.0;
 
   model_->takeAction(Actions::GET_CONSTRAINTS, params, globdat);
   model_->takeAction(Actions::GET_EXT_VECTOR, params, globdat);
   model_->takeAction(Actions::GET_INT_VECTOR, params, globdat);
 
-  return Vector(fext - fint);
+  fres = fext_ - fint_;
 }
 
 //-----------------------------------------------------------------------
@@ -430,7 +533,7 @@ void ExplicitModule::updateMass_(const Properties &globdat)
       << " ...Updating mass information for explicit solver\n";
   model_->takeAction(Actions::UPD_MATRIX2, params, globdat);
 
-  if (dofsSO3_.size())
+  if (dofsSO3_.size() && !dofsValid_)
   {
     IdxVector iitems(dofs_->getItems()->size());
     iitems = jem::iarray(dofs_->getItems()->size());
@@ -443,6 +546,16 @@ void ExplicitModule::updateMass_(const Properties &globdat)
       dofs_->getDofsForType(rdofs_(idof, ALL), iitems, dofsSO3_[idof]);
   }
 
+  // rotations are dimensionless, translations are scaled by the length scale
+  if (!dofsValid_)
+  {
+    dofScale_.resize(dofs_->dofCount());
+    dofScale_ = 1. / lenScale_;
+    for (idx_t inode = 0; inode < rdofs_.size(1); inode++)
+      for (idx_t i = 0; i < rdofs_.size(0); i++)
+        dofScale_[rdofs_(i, inode)] = 1.;
+  }
+
   if (mode_ == LUMPED)
   {
     Ref<DiagMatrixObject> inertia;
@@ -455,7 +568,114 @@ void ExplicitModule::updateMass_(const Properties &globdat)
     massInv_ = 1 / massInv_;
   }
 
+  // the stable step follows the mass and the current stiffness
+  updateStableStep_(globdat);
+
+  // the work arrays only depend on the dof space
+  if (!dofsValid_)
+  {
+    initWork_();
+    initParams_();
+  }
+
   valid_ = true;
+  dofsValid_ = true;
+}
+
+//-----------------------------------------------------------------------
+//   initWork_
+//-----------------------------------------------------------------------
+
+void ExplicitModule::initWork_()
+{
+  const idx_t dofCount = dofs_->dofCount();
+  const idx_t rotCount = dofsSO3_.size();
+  const idx_t nodeCount = rotCount ? rdofs_.size(1) : 0;
+
+  resizeWork_(fint_, dofCount);
+  resizeWork_(fext_, dofCount);
+  resizeWork_(fres_, dofCount);
+  resizeWork_(du_, dofCount);
+  resizeWork_(dv_, dofCount);
+  resizeWork_(uCur_, dofCount);
+  resizeWork_(vCur_, dofCount);
+  resizeWork_(aCur_, dofCount);
+  resizeWork_(uNew_, dofCount);
+  resizeWork_(vNew_, dofCount);
+  resizeWork_(aNew_, dofCount);
+
+  resizeWork_(rotNode_, nodeCount, rotCount);
+  resizeWork_(rotDelta_, nodeCount, rotCount);
+  resizeWork_(rotOld_, nodeCount, rotCount * rotCount);
+  resizeWork_(rotNew_, nodeCount, rotCount * rotCount);
+  resizeWork_(rotUpd_, nodeCount, rotCount * rotCount);
+}
+
+//-----------------------------------------------------------------------
+//   initParams_
+//-----------------------------------------------------------------------
+
+void ExplicitModule::initParams_()
+{
+  forceParams_.resize(maxStepLevel_ + 2);
+
+  for (idx_t i = 0; i < forceParams_.size(); i++)
+  {
+    Properties params;
+
+    params.set(ActionParams::EXT_VECTOR, fext_);
+    params.set(ActionParams::INT_VECTOR, fint_);
+    params.set(ActionParams::CONSTRAINTS, cons_);
+    if (mode_ == CONSISTENT)
+      params.set(ActionParams::MATRIX2, solver_->getMatrix());
+    if (i > 0)
+      params.set(SolverNames::STEP_LEVEL, i - 1);
+
+    forceParams_[i] = params;
+  }
+}
+
+//-----------------------------------------------------------------------
+//   updateStableStep_
+//-----------------------------------------------------------------------
+
+void ExplicitModule::updateStableStep_(const Properties &globdat)
+{
+  Properties params;
+  double dtime_crit = jem::Float::MAX_VALUE;
+
+  if (stableFact_ <= 0.)
+    return;
+
+  if (maxStepLevel_ > 0)
+    params.set(SolverNames::MAX_STEP_LEVEL, maxStepLevel_);
+
+  model_->takeAction(SolverNames::GET_STABLE_STEP_SIZE, params, globdat);
+  params.find(dtime_crit, SolverNames::STABLE_STEP_SIZE);
+
+  // a subcycled step consists of 2^level steps of the finest level
+  stepLevel_ = 0;
+  if (maxStepLevel_ > 0)
+    params.find(stepLevel_, SolverNames::STEP_LEVEL);
+
+  stableDtime_ = stableFact_ * dtime_crit * (double)((idx_t)1 << stepLevel_);
+
+  jem::System::info(myName_)
+      << " ...Stable time step size " << stableDtime_ << "\n";
+  if (stepLevel_ > 0)
+    jem::System::info(myName_)
+        << " ...Subcycling with " << ((idx_t)1 << stepLevel_) << " substeps per step\n";
+  // clamping to minDtime_ would silently step beyond the stable limit
+  if (stableDtime_ < minDtime_)
+    throw jem::IllegalInputException(
+        getContext(),
+        String::format("stable time step size %g is below the smallest allowed "
+                       "time step %g, decrease %s",
+                       stableDtime_, minDtime_, jive::implict::PropNames::MIN_DTIME));
+
+  dtime_ = jem::max(jem::min(dtime_, stableDtime_), minDtime_);
+  Globdat::getVariables(globdat).set(jive::implict::PropNames::DELTA_TIME,
+                                     dtime_);
 }
 
 //-----------------------------------------------------------------------
@@ -465,6 +685,7 @@ void ExplicitModule::updateMass_(const Properties &globdat)
 void ExplicitModule::invalidate_()
 {
   valid_ = false;
+  dofsValid_ = false;
 }
 
 //-----------------------------------------------------------------------
@@ -493,11 +714,29 @@ ExplicitModule::getPrecision() const
 double
 ExplicitModule::getQuality(const Vector &y_pre, const Vector &y_cor)
 {
-  Vector y_diff = Vector(y_pre - y_cor);
-  for (idx_t i = 0; i < y_diff.size(); i++)
-    if (!jem::testany(rdofs_ == i))
-      y_diff[i] /= lenScale_;
-  return norm2(y_diff) / sqrt(static_cast<double>(y_diff.size()));
+  const idx_t dofCount = y_pre.size();
+
+  if (dofCount == 0)
+    return 0.;
+
+  JEM_ASSERT2(y_cor.size() == dofCount && dofScale_.size() == dofCount,
+              "vectors do not match the dof space");
+  JEM_ASSERT2(y_pre.stride() == 1 && y_cor.stride() == 1,
+              "vectors need to be contiguous");
+
+  const double *pre = &y_pre[0];
+  const double *cor = &y_cor[0];
+  const double *scale = &dofScale_[0];
+  double sum = 0.;
+
+#pragma omp simd reduction(+ : sum)
+  for (idx_t i = 0; i < dofCount; i++)
+  {
+    const double diff = (pre[i] - cor[i]) * scale[i];
+    sum += diff * diff;
+  }
+
+  return sqrt(sum / static_cast<double>(dofCount));
 }
 
 // //-----------------------------------------------------------------------
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "utils/batchSO3.h"
 #include "utils/helpers.h"
 #include <jem/base/ArithmeticException.h>
 #include <jem/base/Array.h>
@@ -45,6 +46,7 @@
 #include <jive/util/ItemSet.h>
 #include <jive/util/XTable.h>
 
+using jem::Array;
 using jem::idx_t;
 using jem::newInstance;
 using jem::numeric::Function;
@@ -78,8 +80,11 @@ using jive::util::Globdat;
 using jive::util::ItemSet;
 using jive::util::XTable;
 
+using jive_helpers::composeBatch;
 using jive_helpers::expVec;
+using jive_helpers::expVecBatch;
 using jive_helpers::logMat;
+using jive_helpers::logMatBatch;
 
 //-----------------------------------------------------------------------
 //   class ExplicitModule
@@ -89,6 +94,14 @@ using jive_helpers::logMat;
 /// @details Provides foundation for explicit solvers with support for rotational DOFs,
 /// adaptive time stepping, and both lumped and consistent mass matrices. Handles
 /// special integration of SO(3) rotational degrees of freedom using exponential maps.
+///
+/// With batchSteps > 1 a single run performs up to that many accepted steps,
+/// so the control and output modules are only called at batch boundaries.
+/// The optional batchBreak condition ends a batch early (e.g. at sampling
+/// times). Without it, the conditions of the control and output modules are
+/// only checked at batch boundaries, which is reported as a warning. Every
+/// inner step is committed, so each batch ends in a regular, restartable
+/// state.
 class ExplicitModule : public SolverModule
 {
 public:
@@ -103,10 +116,13 @@ public:
 
   /// @name Property identifiers
   /// @{
-  static const char *TYPE_NAME;  ///< Module type name
-  static const char *STEP_COUNT; ///< Step count property
-  static const char *SO3_DOFS;   ///< SO(3) DOF types property
-  static const char *LEN_SCALE;  ///< Length scale property
+  static const char *TYPE_NAME;     ///< Module type name
+  static const char *STEP_COUNT;    ///< Step count property
+  static const char *SO3_DOFS;      ///< SO(3) DOF types property
+  static const char *LEN_SCALE;     ///< Length scale property
+  static const char *STABLE_FACTOR; ///< Fraction of the critical time step property
+  static const char *BATCH_STEPS;   ///< Steps per run property
+  static const char *BATCH_BREAK;   ///< Condition ending a batch property
   /// @}
 
   /// @brief Initialize the module
@@ -134,6 +150,11 @@ public:
   virtual void getConfig(const Properties &props,
                          const Properties &globdat) const override;
 
+  /// @brief Run a batch of time steps
+  /// @param globdat Global data container
+  /// @return Module status
+  virtual Status run(const Properties &globdat) override;
+
   /// @brief Advance to next time step
   /// @param globdat Global data container
   virtual void advance(const Properties &globdat) override;
@@ -177,9 +198,36 @@ protected:
   virtual ~ExplicitModule();
 
   /// @brief Update mass matrix
+  /// @details Also refreshes the stable time step if it is enabled
   /// @param globdat Global data container
   void updateMass_(const Properties &globdat);
 
+  /// @brief Update the stable time step from the critical step of the models
+  /// @param globdat Global data container
+  void updateStableStep_(const Properties &globdat);
+
+  /// @brief Size the persistent work arrays for the current DOF space
+  /// @details Called at the end of updateMass_, so the step loops reuse the
+  /// same arrays. Derived modules size their own work arrays after calling the
+  /// base implementation.
+  virtual void initWork_();
+
+  /// @brief Bind the force work vectors to persistent action parameters
+  /// @details One parameter set per subcycling level, so that the step
+  /// loops do not build new property sets
+  virtual void initParams_();
+
+  /// @brief Resize a work vector if its size changed
+  /// @param work Work vector
+  /// @param size Required size
+  inline void resizeWork_(Vector &work, const idx_t size);
+
+  /// @brief Resize a work matrix if its shape changed
+  /// @param work Work matrix
+  /// @param rows Required number of rows
+  /// @param cols Required number of columns
+  inline void resizeWork_(Matrix &work, const idx_t rows, const idx_t cols);
+
   /// @brief invalidate_ current state
   void invalidate_();
 
@@ -218,15 +266,17 @@ protected:
                const Properties &globdat);
 
   /// @brief Get force vector
-  /// @param fint Internal force vector
-  /// @param fext External force vector
+  /// @details The internal and external parts are left in fint_ and fext_
+  /// @param fres Resulting force vector, external - internal (output)
   /// @param globdat Global data container
-  /// @return Resulting force vector (external - internal)
-  Vector getForce(const Vector &fint,
-                  const Vector &fext,
-                  const Properties &globdat);
+  /// @param level Coarsest subcycling level to re-evaluate (-1 without subcycling)
+  void getForce(const Vector &fres,
+                const Properties &globdat,
+                const idx_t level = -1);
 
   /// @brief Get solution quality measure
+  /// @details Root mean square of the difference, with translations scaled
+  /// by the length scale (see dofScale_)
   /// @param y_pre Predicted solution
   /// @param y_cor Corrected solution
   /// @return Quality measure
@@ -236,18 +286,33 @@ protected:
 protected:
   /// @name Module state
   /// @{
-  bool valid_; ///< State validity flag
+  bool valid_;     ///< State validity flag
+  bool dofsValid_; ///< Dof dependent data validity flag
   /// @}
 
   /// @name Time stepping parameters
   /// @{
-  double dtime_;    ///< Current time step size
-  double prec_;     ///< Precision tolerance
-  double minDtime_; ///< Minimum time step size
-  double maxDtime_; ///< Maximum time step size
-  double saftey_;   ///< Safety factor for step size control
-  double incrFact_; ///< Step size increase factor
-  double decrFact_; ///< Step size decrease factor
+  double dtime_;       ///< Current time step size
+  double prec_;        ///< Precision tolerance
+  double minDtime_;    ///< Minimum time step size
+  double maxDtime_;    ///< Maximum time step size
+  double saftey_;      ///< Safety factor for step size control
+  double incrFact_;    ///< Step size increase factor
+  double decrFact_;    ///< Step size decrease factor
+  double stableFact_;  ///< Fraction of the critical time step (0 to disable)
+  double stableDtime_; ///< Largest stable time step size
+  /// @}
+
+  /// @name Step batching parameters
+  /// @{
+  idx_t batchSteps_;         ///< Largest number of accepted steps per run
+  Ref<Function> batchBreak_; ///< Condition ending a batch early
+  /// @}
+
+  /// @name Subcycling parameters
+  /// @{
+  idx_t maxStepLevel_; ///< Largest requested subcycling level (0 to disable)
+  idx_t stepLevel_;    ///< Coarsest subcycling level of the models
   /// @}
 
   /// @name Integration parameters
@@ -263,6 +328,7 @@ protected:
   Vector massInv_;        ///< Inverse mass matrix
   IdxVector dofsSO3_;     ///< SO(3) DOF type indices
   IdxMatrix rdofs_;       ///< Rotational DOF mapping
+  Vector dofScale_;       ///< Error scale per DOF (1/lenScale_ for translations)
   /// @}
 
   /// @name System components
@@ -272,6 +338,32 @@ protected:
   Ref<Constraints> cons_; ///< Constraint manager
   Ref<Solver> solver_;    ///< Linear solver
   /// @}
+
+  /// @name Work arrays (sized in initWork_)
+  /// @{
+  Vector fint_;      ///< Internal force vector
+  Vector fext_;      ///< External force vector
+  Vector fres_;      ///< Resulting force vector
+  Vector du_;        ///< Displacement increment
+  Vector dv_;        ///< Velocity increment
+  Vector uCur_;      ///< Displacements at the start of the step
+  Vector vCur_;      ///< Velocities at the start of the step
+  Vector aCur_;      ///< Accelerations at the start of the step
+  Vector uNew_;      ///< New displacements
+  Vector vNew_;      ///< New velocities
+  Vector aNew_;      ///< New accelerations
+  Matrix rotNode_;   ///< Rotation vectors per node (SoA)
+  Matrix rotDelta_;  ///< Rotation increments per node (SoA)
+  Matrix rotOld_;    ///< Old rotation matrices per node (SoA)
+  Matrix rotNew_;    ///< New rotation matrices per node (SoA)
+  Matrix rotUpd_;    ///< Incremental rotation matrices per node (SoA)
+  /// @}
+
+  /// @name Action parameters (built in initParams_)
+  /// @{
+  Array<Properties> forceParams_; ///< Force parameters per level (level + 1)
+  Properties stepParams_;         ///< Parameters of the step actions
+  /// @}
 };
 
 //-----------------------------------------------------------------------
@@ -290,3 +382,21 @@ inline void ExplicitModule::ABupdate(const Vector &delta_y,
 {
   delta_y = dtime_ * f_cur;
 }
+
+inline void ExplicitModule::resizeWork_(Vector &work, const idx_t size)
+{
+  if (work.size() == size)
+    return;
+
+  work.resize(size);
+}
+
+inline void ExplicitModule::resizeWork_(Matrix &work,
+                                        const idx_t rows,
+                                        const idx_t cols)
+{
+  if (work.size(0) == rows && work.size(1) == cols)
+    return;
+
+  work.resize(rows, cols);
+}
@@ -24,6 +24,7 @@ JEM_DEFINE_CLASS(LeapFrogModule);
 //-----------------------------------------------------------------------
 
 const char *LeapFrogModule::TYPE_NAME = "LeapFrog";
+const char *LeapFrogModule::SUBCYCLE_LEVELS = "subcycleLevels";
 
 //-----------------------------------------------------------------------
 //   constructor & destructor
@@ -31,12 +32,34 @@ const char *LeapFrogModule::TYPE_NAME = "LeapFrog";
 
 LeapFrogModule::LeapFrogModule(const String &name) : Super(name)
 {
+  // without an error estimate the step size is only bounded by stability
+  stableFact_ = 0.9;
 }
 
 LeapFrogModule::~LeapFrogModule()
 {
 }
 
+//-----------------------------------------------------------------------
+//   init
+//-----------------------------------------------------------------------
+
+Module::Status LeapFrogModule::init
+
+    (const Properties &conf, const Properties &props,
+     const Properties &globdat)
+
+{
+  Properties myConf = conf.makeProps(myName_);
+  Properties myProps = props.findProps(myName_);
+
+  // the step levels are assigned with the stable time step
+  myProps.find(maxStepLevel_, SUBCYCLE_LEVELS, 0, 16);
+  myConf.set(SUBCYCLE_LEVELS, maxStepLevel_);
+
+  return Super::init(conf, props, globdat);
+}
+
 //-----------------------------------------------------------------------
 //   solve
 //-----------------------------------------------------------------------
@@ -45,40 +68,52 @@ void LeapFrogModule::solve(const Properties &info, const Properties &globdat)
 
 {
   using jive::model::STATE;
-  const idx_t dofCount = dofs_->dofCount();
-
-  idx_t step;
-  Properties params;
-  Vector fint(dofCount);
-  Vector fext(dofCount);
-  Vector fres(dofCount);
-  Vector u_old, v_old, a_old;
-  Vector dv(dofCount);
-  Vector du(dofCount);
-  Vector u_new(dofCount);
-  Vector v_new(dofCount);
-  Vector a_new(dofCount);
-
-  globdat.get(step, Globdat::TIME_STEP);
+  const idx_t subCount = (idx_t)1 << stepLevel_;
+  const double dt = dtime_ / (double)subCount;
+
+  idx_t level;
+  double t_new;
+  Vector u_state, v_state;
 
   // Get the state vectors from the last time step (velocities actually at
-  // half steps!)
-  StateVector::get(u_old, STATE[0], dofs_, globdat);
-  StateVector::get(v_old, STATE[1], dofs_, globdat);
-  StateVector::get(a_old, STATE[2], dofs_, globdat);
-  params.clear();
-
-  // Compute new accelerations
-  fres = getForce(fint, fext, globdat);
-  getAcce(a_new, cons_, fres, globdat);
-
-  // update velocity
-  ABupdate(dv, a_new);
-  updateVec(v_new, v_old, dv);
-
-  // update position
-  ABupdate(du, v_new);
-  updateVec(u_new, u_old, du, true);
+  // half steps!), copies, the state is overwritten below
+  StateVector::get(u_state, STATE[0], dofs_, globdat);
+  StateVector::get(v_state, STATE[1], dofs_, globdat);
+  uCur_ = u_state;
+  vCur_ = v_state;
+  globdat.get(t_new, Globdat::TIME);
+
+  for (idx_t isub = 0; isub < subCount; isub++)
+  {
+    // the coarsest level that starts a new step at this substep
+    level = 0;
+    while (level < stepLevel_ && isub % ((idx_t)2 << level) == 0)
+      level++;
+
+    // loads and constraints at the end of the substep, the last one ends
+    // at the time of the step
+    globdat.set(Globdat::TIME, t_new - (double)(subCount - 1 - isub) * dt);
+
+    // Compute new accelerations
+    getForce(fres_, globdat, stepLevel_ > 0 ? level : -1);
+    getAcce(aNew_, cons_, fres_, globdat);
+
+    // update velocity
+    dv_ = dt * aNew_;
+    updateVec(vNew_, vCur_, dv_);
+
+    // update position
+    du_ = dt * vNew_;
+    updateVec(uNew_, uCur_, du_, true);
+
+    StateVector::store(uNew_, STATE[0], dofs_, globdat);
+    StateVector::store(vNew_, STATE[1], dofs_, globdat);
+    StateVector::store(aNew_, STATE[2], dofs_, globdat);
+
+    // the next substep starts from this one
+    uCur_ = uNew_;
+    vCur_ = vNew_;
+  }
 
   info.set(SolverInfo::RESIDUAL, 0.);
 }
@@ -23,7 +23,14 @@
 /// The leap-frog method is symplectic and second-order accurate, making it
 /// well-suited for long-time dynamic simulations where energy conservation
 /// is important. It inherits basic explicit integration functionality from
-/// ExplicitModule.
+/// ExplicitModule. The time step grows up to 90% of the critical time step
+/// of the models (stableStepFactor) by default.
+///
+/// With subcycleLevels > 0 a step is split into 2^level substeps of the
+/// finest level. Lattice children that are stable at coarser steps are only
+/// evaluated at the start of their own (power-of-two) step and their forces
+/// are held in between. External loads and constraints follow the time of
+/// every substep.
 /// @see [Leap-frog integration](https://en.wikipedia.org/wiki/Leapfrog_integration)
 class LeapFrogModule : public ExplicitModule
 {
@@ -32,13 +39,23 @@ public:
 
   /// @name Property identifiers
   /// @{
-  static const char *TYPE_NAME; ///< Module type name
+  static const char *TYPE_NAME;       ///< Module type name
+  static const char *SUBCYCLE_LEVELS; ///< Largest subcycling level property
   /// @}
 
   /// @brief Constructor
   /// @param name Module name (default: "leapFrog")
   explicit LeapFrogModule(const String &name = "leapFrog");
 
+  /// @brief Initialize the module
+  /// @param conf Actually used configuration properties (output)
+  /// @param props User-specified module properties
+  /// @param globdat Global data container
+  /// @return Module status
+  virtual Status init(const Properties &conf,
+                      const Properties &props,
+                      const Properties &globdat) override;
+
   /// @brief Solve using leap-frog integration scheme
   /// @param info Solver information (output)
   /// @param globdat Global data container
@@ -46,6 +63,8 @@ public:
   /// 1. Compute forces and accelerations at current time
   /// 2. Update velocities using current and previous accelerations
   /// 3. Update positions using updated velocities
+  ///
+  /// With subcycling these are repeated for every substep.
   virtual void solve(const Properties &info, const Properties &globdat) override;
 
   /// @brief Factory method for creating new LeapFrogModule instances
@@ -0,0 +1,484 @@
+/**
+ * @file MatrixFreeNonlinModule.cpp
+ * @author Til Gärtner
+ * @brief Implementation of MatrixFreeNonlinModule class
+ */
+
+#include "modules/MatrixFreeNonlinModule.h"
+#include "utils/SolverNames.h"
+#include "utils/testing.h"
+
+#include <jem/base/ClassTemplate.h>
+#include <jem/base/System.h>
+#include <jem/base/array/operators.h>
+#include <jem/numeric/algebra/utilities.h>
+
+//=======================================================================
+//   class MatrixFreeNonlinModule
+//=======================================================================
+
+JEM_DEFINE_CLASS(MatrixFreeNonlinModule);
+
+//-----------------------------------------------------------------------
+//   static data
+//-----------------------------------------------------------------------
+
+const char *MatrixFreeNonlinModule::TYPE_NAME = "MatrixFreeNonlin";
+const char *MatrixFreeNonlinModule::KRYLOV_PRECISION = "krylovPrecision";
+const char *MatrixFreeNonlinModule::KRYLOV_ITER = "maxKrylovIter";
+
+//-----------------------------------------------------------------------
+//   constructor & destructor
+//-----------------------------------------------------------------------
+
+MatrixFreeNonlinModule::MatrixFreeNonlinModule(const String &name) : Super(name)
+{
+  prec_ = 1e-5;
+  maxIter_ = 20;
+  krylovPrec_ = 1e-8;
+  krylovIter_ = 1000;
+}
+
+MatrixFreeNonlinModule::~MatrixFreeNonlinModule()
+{
+}
+
+//-----------------------------------------------------------------------
+//   init
+//-----------------------------------------------------------------------
+
+Module::Status MatrixFreeNonlinModule::init
+
+    (const Properties &conf, const Properties &props,
+     const Properties &globdat)
+
+{
+  Properties params;
+
+  configure(props, globdat);
+  getConfig(conf, globdat);
+
+  model_ = Model::get(globdat, getContext());
+  dofs_ = DofSpace::get(globdat, getContext());
+  cons_ = Constraints::get(dofs_, globdat);
+
+  Globdat::initStep(globdat);
+  model_->takeAction(Actions::INIT, params, globdat);
+
+  return OK;
+}
+
+//-----------------------------------------------------------------------
+//   shutdown
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::shutdown(const Properties &globdat)
+{
+  (void)globdat; // unused
+
+  model_ = nullptr;
+  dofs_ = nullptr;
+  cons_ = nullptr;
+}
+
+//-----------------------------------------------------------------------
+//   configure
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::configure
+
+    (const Properties &props, const Properties &globdat)
+
+{
+  (void)globdat; // unused
+
+  using jive::implict::PropNames;
+  Properties myProps = props.findProps(myName_);
+
+  myProps.find(prec_, PropNames::PRECISION, 0., 1.);
+  myProps.find(maxIter_, PropNames::MAX_ITER, 1, 1000);
+  myProps.find(krylovPrec_, KRYLOV_PRECISION, 0., 1.);
+  myProps.find(krylovIter_, KRYLOV_ITER, 1, 1000000);
+}
+
+//-----------------------------------------------------------------------
+//   getConfig
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::getConfig
+
+    (const Properties &conf, const Properties &globdat) const
+
+{
+  (void)globdat; // unused
+
+  using jive::implict::PropNames;
+  Properties myConf = conf.makeProps(myName_);
+
+  myConf.set(PropNames::PRECISION, prec_);
+  myConf.set(PropNames::MAX_ITER, maxIter_);
+  myConf.set(KRYLOV_PRECISION, krylovPrec_);
+  myConf.set(KRYLOV_ITER, krylovIter_);
+}
+
+//-----------------------------------------------------------------------
+//   advance
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::advance(const Properties &globdat)
+{
+  Properties params;
+
+  Globdat::advanceStep(globdat);
+  model_->takeAction(Actions::ADVANCE, params, globdat);
+}
+
+//-----------------------------------------------------------------------
+//   solve
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::solve(const Properties &info,
+                                   const Properties &globdat)
+{
+  Properties params;
+  Vector u;
+  Ref<AbstractMatrix> K;
+  double resNorm = 0.;
+  double refNorm = 0.;
+  idx_t krylovCount = 0;
+  idx_t iiter;
+  bool converged = false;
+
+  initWork_();
+
+  // update the constraints and impose the prescribed values
+  params.set(ActionParams::CONSTRAINTS, cons_);
+  model_->takeAction(Actions::GET_CONSTRAINTS, params, globdat);
+
+  initConstraints_();
+
+  StateVector::get(u, dofs_, globdat);
+  jive::util::setSlaveDofs(u, *cons_);
+
+  for (iiter = 0; iiter <= maxIter_; iiter++)
+  {
+    K = getResidual_(globdat);
+
+    resNorm = jem::numeric::norm2(res_);
+    refNorm = jem::max(refNorm, jem::numeric::norm2(fext_ * free_),
+                       jem::numeric::norm2(fint_ * free_));
+
+    jem::System::info(myName_)
+        << " ...Iteration " << iiter << ", residual norm " << resNorm << "\n";
+
+    if (resNorm <= prec_ * refNorm || jem::isTiny(resNorm))
+    {
+      converged = true;
+      break;
+    }
+
+    if (iiter == maxIter_)
+      break;
+
+    const idx_t krylovSteps = solveKrylov_(du_, *K, res_);
+
+    if (krylovSteps < 0)
+      jem::System::warn() << myName_ << " ...Krylov solver did not converge in "
+                          << krylovIter_ << " iterations\n";
+    krylovCount += jem::abs(krylovSteps);
+
+    u += du_;
+    jive::util::setSlaveDofs(u, *cons_);
+  }
+
+  info.set(SolverInfo::CONVERGED, converged);
+  info.set(SolverInfo::RESIDUAL, resNorm);
+  info.set(SolverInfo::ITER_COUNT, iiter);
+
+  jem::System::info(myName_)
+      << " ..." << krylovCount << " Krylov iterations in " << iiter
+      << " Newton iterations\n";
+
+  if (!converged)
+    throw jive::solver::SolverException(
+        getContext(),
+        String::format("no convergence achieved in %d iterations", maxIter_));
+}
+
+//-----------------------------------------------------------------------
+//   cancel
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::cancel(const Properties &globdat)
+{
+  Properties params;
+
+  Globdat::restoreStep(globdat);
+  StateVector::restoreNew(dofs_, globdat);
+  model_->takeAction(Actions::CANCEL, params, globdat);
+}
+
+//-----------------------------------------------------------------------
+//   commit
+//-----------------------------------------------------------------------
+
+bool MatrixFreeNonlinModule::commit(const Properties &globdat)
+{
+  Properties params;
+  bool accept = true;
+
+  if (model_->takeAction(Actions::CHECK_COMMIT, params, globdat))
+    params.find(accept, ActionParams::ACCEPT);
+
+  if (accept)
+  {
+    params.clear();
+    model_->takeAction(Actions::COMMIT, params, globdat);
+    Globdat::commitStep(globdat);
+    StateVector::updateOld(dofs_, globdat);
+  }
+
+  return accept;
+}
+
+//-----------------------------------------------------------------------
+//   setPrecision
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::setPrecision(double eps)
+{
+  prec_ = eps;
+}
+
+//-----------------------------------------------------------------------
+//   getPrecision
+//-----------------------------------------------------------------------
+
+double MatrixFreeNonlinModule::getPrecision() const
+{
+  return prec_;
+}
+
+//-----------------------------------------------------------------------
+//   getResidual_
+//-----------------------------------------------------------------------
+
+Ref<AbstractMatrix> MatrixFreeNonlinModule::getResidual_(const Properties &globdat)
+{
+  Properties params;
+  Ref<AbstractMatrix> K;
+
+  fint_ = 0.;
+  fext_ = 0.;
+
+  params.set(ActionParams::INT_VECTOR, fint_);
+  params.set(ActionParams::EXT_VECTOR, fext_);
+
+  if (!model_->takeAction(SolverNames::GET_TANGENT_OPERATOR, params, globdat))
+    throw jem::IllegalInputException(
+        getContext(), "the model does not provide a matrix-free tangent");
+
+  params.get(K, SolverNames::TANGENT_OPERATOR);
+  model_->takeAction(Actions::GET_EXT_VECTOR, params, globdat);
+
+  // T^T r, the slave entries act on their masters
+  res_ = fext_ - fint_;
+  reduceSlaves_(res_);
+  res_ *= free_;
+
+  return K;
+}
+
+//-----------------------------------------------------------------------
+//   solveKrylov_
+//-----------------------------------------------------------------------
+
+idx_t MatrixFreeNonlinModule::solveKrylov_(const Vector &x,
+                                           const AbstractMatrix &K,
+                                           const Vector &b)
+{
+  using jem::numeric::dotProduct;
+  using jem::numeric::norm2;
+
+  const double tol = krylovPrec_ * norm2(b);
+
+  double rho = 1.;
+  double alpha = 1.;
+  double omega = 1.;
+
+  x = 0.;
+  r_ = b;
+  rHat_ = b;
+  p_ = 0.;
+  v_ = 0.;
+
+  for (idx_t iiter = 1; iiter <= krylovIter_; iiter++)
+  {
+    const double rhoNew = dotProduct(rHat_, r_);
+
+    // breakdown of the shadow residual
+    if (jem::isTiny(rhoNew))
+      return -iiter;
+
+    p_ = r_ + (rhoNew / rho) * (alpha / omega) * (p_ - omega * v_);
+
+    applyTangent_(v_, K, p_);
+
+    alpha = rhoNew / dotProduct(rHat_, v_);
+    x += alpha * p_;
+    r_ -= alpha * v_;
+
+    if (norm2(r_) <= tol)
+      return iiter;
+
+    applyTangent_(t_, K, r_);
+
+    omega = dotProduct(t_, r_) / dotProduct(t_, t_);
+    x += omega * r_;
+    r_ -= omega * t_;
+
+    if (norm2(r_) <= tol)
+      return iiter;
+
+    rho = rhoNew;
+  }
+
+  return -krylovIter_;
+}
+
+//-----------------------------------------------------------------------
+//   applyTangent_
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::applyTangent_(const Vector &y,
+                                           const AbstractMatrix &K,
+                                           const Vector &x)
+{
+  x_ = x;
+  expandSlaves_(x_);
+  K.matmul(y, x_);
+  reduceSlaves_(y);
+  y *= free_;
+}
+
+//-----------------------------------------------------------------------
+//   initConstraints_
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::initConstraints_()
+{
+  const idx_t slaveCount = cons_->slaveDofCount();
+  double rval;
+
+  slaveDofs_.resize(slaveCount);
+  masterOffsets_.resize(slaveCount + 1);
+  cons_->getSlaveDofs(slaveDofs_);
+
+  masterOffsets_[0] = 0;
+  for (idx_t is = 0; is < slaveCount; is++)
+    masterOffsets_[is + 1] =
+        masterOffsets_[is] + cons_->masterDofCount(slaveDofs_[is]);
+
+  masterDofs_.resize(masterOffsets_[slaveCount]);
+  masterCoeffs_.resize(masterOffsets_[slaveCount]);
+
+  for (idx_t is = 0; is < slaveCount; is++)
+  {
+    const idx_t first = masterOffsets_[is];
+    const idx_t last = masterOffsets_[is + 1];
+
+    if (last > first)
+      cons_->getConstraint(rval, masterDofs_[jem::SliceFromTo(first, last)],
+                           masterCoeffs_[jem::SliceFromTo(first, last)],
+                           slaveDofs_[is]);
+  }
+
+  free_ = 1.;
+  free_[slaveDofs_] = 0.;
+}
+
+//-----------------------------------------------------------------------
+//   expandSlaves_
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::expandSlaves_(const Vector &x) const
+{
+  for (idx_t is = 0; is < slaveDofs_.size(); is++)
+  {
+    double val = 0.;
+
+    for (idx_t j = masterOffsets_[is]; j < masterOffsets_[is + 1]; j++)
+      val += masterCoeffs_[j] * x[masterDofs_[j]];
+
+    x[slaveDofs_[is]] = val;
+  }
+}
+
+//-----------------------------------------------------------------------
+//   reduceSlaves_
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::reduceSlaves_(const Vector &y) const
+{
+  for (idx_t is = 0; is < slaveDofs_.size(); is++)
+  {
+    const double val = y[slaveDofs_[is]];
+
+    for (idx_t j = masterOffsets_[is]; j < masterOffsets_[is + 1]; j++)
+      y[masterDofs_[j]] += masterCoeffs_[j] * val;
+
+    y[slaveDofs_[is]] = 0.;
+  }
+}
+
+//-----------------------------------------------------------------------
+//   initWork_
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::initWork_()
+{
+  const idx_t dofCount = dofs_->dofCount();
+
+  if (fint_.size() == dofCount)
+    return;
+
+  fint_.resize(dofCount);
+  fext_.resize(dofCount);
+  res_.resize(dofCount);
+  du_.resize(dofCount);
+  free_.resize(dofCount);
+  r_.resize(dofCount);
+  rHat_.resize(dofCount);
+  p_.resize(dofCount);
+  v_.resize(dofCount);
+  t_.resize(dofCount);
+  x_.resize(dofCount);
+}
+
+//-----------------------------------------------------------------------
+//   makeNew
+//-----------------------------------------------------------------------
+
+Ref<Module> MatrixFreeNonlinModule::makeNew
+
+    (const String &name, const Properties &conf, const Properties &props,
+     const Properties &globdat)
+
+{
+  (void)conf;    // unused
+  (void)props;   // unused
+  (void)globdat; // unused
+
+  return newInstance<Self>(name);
+}
+
+//-----------------------------------------------------------------------
+//   declare
+//-----------------------------------------------------------------------
+
+void MatrixFreeNonlinModule::declare()
+{
+  using jive::app::ModuleFactory;
+
+  ModuleFactory::declare(TYPE_NAME, &MatrixFreeNonlinModule::makeNew);
+}
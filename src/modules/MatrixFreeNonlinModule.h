@@ -0,0 +1,226 @@
+/**
+ * @file MatrixFreeNonlinModule.h
+ * @author Til Gärtner
+ * @brief Newton-Krylov solver on matrix-free tangent operators
+ *
+ * This module solves the nonlinear equilibrium equations with Newton's method
+ * without assembling a global stiffness matrix. The linear systems are solved
+ * with BiCGSTAB, which only needs products of the tangent with vectors.
+ */
+
+#pragma once
+
+#include <jem/base/Class.h>
+#include <jem/util/Properties.h>
+#include <jive/algebra/AbstractMatrix.h>
+#include <jive/app/ModuleFactory.h>
+#include <jive/implict/Names.h>
+#include <jive/implict/SolverInfo.h>
+#include <jive/implict/SolverModule.h>
+#include <jive/model/Actions.h>
+#include <jive/model/Model.h>
+#include <jive/model/StateVector.h>
+#include <jive/solver/SolverException.h>
+#include <jive/util/Constraints.h>
+#include <jive/util/DofSpace.h>
+#include <jive/util/Globdat.h>
+#include <jive/util/utilities.h>
+
+using jem::newInstance;
+using jive::idx_t;
+using jive::IdxVector;
+using jive::Properties;
+using jive::Ref;
+using jive::String;
+using jive::Vector;
+using jive::algebra::AbstractMatrix;
+using jive::app::Module;
+using jive::implict::SolverInfo;
+using jive::implict::SolverModule;
+using jive::model::ActionParams;
+using jive::model::Actions;
+using jive::model::Model;
+using jive::model::StateVector;
+using jive::util::Constraints;
+using jive::util::DofSpace;
+using jive::util::Globdat;
+
+//-----------------------------------------------------------------------
+//   class MatrixFreeNonlinModule
+//-----------------------------------------------------------------------
+
+/// @brief Newton-Krylov solver for models with matrix-free tangents
+/// @details Every Newton iteration requests the internal forces together with
+/// the tangent operator (SolverNames::GET_TANGENT_OPERATOR) and solves for the
+/// correction with unpreconditioned BiCGSTAB. The global stiffness matrix is
+/// never stored, so the memory only grows with the number of DOFs.
+///
+/// The prescribed values of the constraints are imposed on the state before
+/// the first iteration. Linear master-slave constraints enter the Krylov
+/// system through the constraint transformation T, i.e. the solver works on
+/// T^T K T and T^T r on the free DOFs, and are re-imposed after every update.
+///
+/// All models contributing a stiffness have to provide a matrix-free tangent,
+/// e.g. rod models with matrixFree = true.
+class MatrixFreeNonlinModule : public SolverModule
+{
+public:
+  JEM_DECLARE_CLASS(MatrixFreeNonlinModule, SolverModule);
+
+  /// @name Property identifiers
+  /// @{
+  static const char *TYPE_NAME;        ///< Module type name
+  static const char *KRYLOV_PRECISION; ///< Relative Krylov tolerance property
+  static const char *KRYLOV_ITER;      ///< Maximum Krylov iterations property
+  /// @}
+
+  /// @brief Constructor
+  /// @param name Module name
+  explicit MatrixFreeNonlinModule(const String &name = "matrixFreeNonlin");
+
+  /// @brief Initialize the module
+  /// @param conf Actually used configuration properties (output)
+  /// @param props User-specified module properties
+  /// @param globdat Global data container
+  /// @return Module status
+  virtual Status init(const Properties &conf,
+                      const Properties &props,
+                      const Properties &globdat) override;
+
+  /// @brief Shutdown the module
+  /// @param globdat Global data container
+  virtual void shutdown(const Properties &globdat) override;
+
+  /// @brief Configure the module from properties
+  /// @param props User-specified module properties
+  /// @param globdat Global data container
+  virtual void configure(const Properties &props,
+                         const Properties &globdat) override;
+
+  /// @brief Get current module configuration
+  /// @param conf Actually used configuration properties (output)
+  /// @param globdat Global data container
+  virtual void getConfig(const Properties &conf,
+                         const Properties &globdat) const override;
+
+  /// @brief Advance to next load step
+  /// @param globdat Global data container
+  virtual void advance(const Properties &globdat) override;
+
+  /// @brief Solve the current load step with Newton's method
+  /// @param info Solver information (output)
+  /// @param globdat Global data container
+  virtual void solve(const Properties &info,
+                     const Properties &globdat) override;
+
+  /// @brief Cancel current solution attempt
+  /// @param globdat Global data container
+  virtual void cancel(const Properties &globdat) override;
+
+  /// @brief Commit current solution
+  /// @param globdat Global data container
+  /// @return true if the step is accepted by the model
+  virtual bool commit(const Properties &globdat) override;
+
+  /// @brief Set convergence precision
+  /// @param eps Convergence tolerance
+  virtual void setPrecision(double eps) override;
+
+  /// @brief Get current convergence precision
+  /// @return Current convergence tolerance
+  virtual double getPrecision() const override;
+
+  /// @brief Factory method for creating new MatrixFreeNonlinModule instances
+  /// @param name Module name
+  /// @param conf Actually used configuration properties (output)
+  /// @param props User-specified module properties
+  /// @param globdat Global data container
+  /// @return Reference to new MatrixFreeNonlinModule instance
+  static Ref<Module> makeNew(const String &name,
+                             const Properties &conf,
+                             const Properties &props,
+                             const Properties &globdat);
+
+  /// @brief Register MatrixFreeNonlinModule type with ModuleFactory
+  static void declare();
+
+protected:
+  /// @brief Protected destructor
+  virtual ~MatrixFreeNonlinModule();
+
+private:
+  /// @brief Evaluate the residual and the tangent at the current state
+  /// @param globdat Global data container
+  /// @return Tangent operator of the model
+  Ref<AbstractMatrix> getResidual_(const Properties &globdat);
+
+  /// @brief Solve the tangent system with BiCGSTAB on the free DOFs
+  /// @param x Solution (output)
+  /// @param K Tangent operator
+  /// @param b Right hand side (zero on the constrained DOFs)
+  /// @return Number of iterations, negative if the solver did not converge
+  idx_t solveKrylov_(const Vector &x,
+                     const AbstractMatrix &K,
+                     const Vector &b);
+
+  /// @brief Apply the constrained tangent T^T K T to a vector
+  /// @param y Product on the free DOFs (output)
+  /// @param K Tangent operator
+  /// @param x Vector on the free DOFs
+  void applyTangent_(const Vector &y,
+                     const AbstractMatrix &K,
+                     const Vector &x);
+
+  /// @brief Store the master DOFs and coefficients of all slave DOFs
+  void initConstraints_();
+
+  /// @brief Set the slave entries to the linear combination of their masters
+  /// @param x Vector to expand (x = T x)
+  void expandSlaves_(const Vector &x) const;
+
+  /// @brief Add the slave entries to their masters and zero them
+  /// @param y Vector to reduce (y = T^T y)
+  void reduceSlaves_(const Vector &y) const;
+
+  /// @brief Size the work vectors for the current DOF space
+  void initWork_();
+
+private:
+  /// @name Solver parameters
+  /// @{
+  double prec_;       ///< Relative precision of the residual
+  idx_t maxIter_;     ///< Maximum number of Newton iterations
+  double krylovPrec_; ///< Relative precision of the Krylov solver
+  idx_t krylovIter_;  ///< Maximum number of Krylov iterations
+  /// @}
+
+  /// @name System components
+  /// @{
+  Ref<Model> model_;      ///< Root of the model tree
+  Ref<DofSpace> dofs_;    ///< Degree of freedom space
+  Ref<Constraints> cons_; ///< Constraint manager
+  /// @}
+
+  /// @name Work vectors
+  /// @{
+  Vector fint_; ///< Internal force vector
+  Vector fext_; ///< External force vector
+  Vector res_;  ///< Residual on the free DOFs
+  Vector du_;   ///< Newton correction
+  Vector free_; ///< 1 for free and 0 for constrained DOFs
+  Vector r_;    ///< Krylov residual
+  Vector rHat_; ///< Krylov shadow residual
+  Vector p_;    ///< Krylov search direction
+  Vector v_;    ///< Tangent times search direction
+  Vector t_;    ///< Tangent times intermediate residual
+  Vector x_;    ///< Krylov vector expanded to the slave DOFs
+  /// @}
+
+  /// @name Constraint transformation (CSR layout per slave DOF)
+  /// @{
+  IdxVector slaveDofs_;     ///< Slave DOFs
+  IdxVector masterOffsets_; ///< Offsets of the masters of every slave
+  IdxVector masterDofs_;    ///< Master DOFs
+  Vector masterCoeffs_;     ///< Coefficients of the master DOFs
+  /// @}
+};
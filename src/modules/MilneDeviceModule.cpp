@@ -41,78 +41,64 @@ MilneDeviceModule::~MilneDeviceModule()
 void MilneDeviceModule::solve(const Properties &info, const Properties &globdat)
 
 {
-  const idx_t dofCount = dofs_->dofCount();
-  idx_t step;
   double correction;
-  Vector u_pre(dofCount);
-  Vector v_pre(dofCount);
-  Vector a_pre(dofCount);
-  Vector u_cur, v_cur;
-  Vector a_cur(dofCount);
-  Vector u_old, v_old, a_old;
-  Vector u_new(dofCount);
-  Vector v_new(dofCount);
-  Vector a_new(dofCount);
-  Vector dv(dofCount);
-  Vector du(dofCount);
-  Vector fres(dofCount);
-  Vector fint(dofCount);
-  Vector fext(dofCount);
+  Vector u_state, v_state;
 
   // set the predictions to zero
-  u_pre = 0.;
-  v_pre = 0.;
-  a_pre = 0.;
-
-  // get the current vectors
-  StateVector::get(u_cur, jive::model::STATE0, dofs_, globdat);
-  StateVector::get(v_cur, jive::model::STATE1, dofs_, globdat);
-  fres = getForce(fint, fext, globdat);
-  getAcce(a_cur, cons_, fres, globdat);
-  globdat.get(step, Globdat::TIME_STEP);
+  uPre_ = 0.;
+  vPre_ = 0.;
+  aPre_ = 0.;
+
+  // get the current vectors (copies, the state is overwritten below)
+  StateVector::get(u_state, jive::model::STATE0, dofs_, globdat);
+  StateVector::get(v_state, jive::model::STATE1, dofs_, globdat);
+  uCur_ = u_state;
+  vCur_ = v_state;
+  getForce(fres_, globdat);
+  getAcce(aCur_, cons_, fres_, globdat);
 
   /////////////////////////////////////////////////
   ////////  predictor step
   /////////////////////////////////////////////////
 
   // predict velocity
-  ABupdate(dv, a_cur);
-  updateVec(v_pre, v_cur, dv);
+  ABupdate(dv_, aCur_);
+  updateVec(vPre_, vCur_, dv_);
 
   // predict displacements
-  ABupdate(du, v_cur);
-  updateVec(u_pre, u_cur, du, true);
+  ABupdate(du_, vCur_);
+  updateVec(uPre_, uCur_, du_, true);
 
   // store predicted variables in StateVectors
-  StateVector::store(u_pre, jive::model::STATE0, dofs_, globdat);
-  StateVector::store(v_pre, jive::model::STATE1, dofs_, globdat);
+  StateVector::store(uPre_, jive::model::STATE0, dofs_, globdat);
+  StateVector::store(vPre_, jive::model::STATE1, dofs_, globdat);
 
   // predict accelerations
-  fres = updForce(fint, fext, globdat);
-  getAcce(a_pre, cons_, fres, globdat);
+  updForce(fres_, globdat);
+  getAcce(aPre_, cons_, fres_, globdat);
 
   /////////////////////////////////////////////////
   ////////  corrector step
   /////////////////////////////////////////////////
 
   // correct velocity
-  AMupdate_(dv, a_pre);
-  updateVec(v_new, v_cur, dv);
+  AMupdate_(dv_, aPre_);
+  updateVec(vNew_, vCur_, dv_);
 
   // correct displacements
-  AMupdate_(du, v_pre);
-  updateVec(u_new, u_cur, du, true);
+  AMupdate_(du_, vPre_);
+  updateVec(uNew_, uCur_, du_, true);
 
   // store corrected variables in StateVectors
-  StateVector::store(u_new, jive::model::STATE0, dofs_, globdat);
-  StateVector::store(v_new, jive::model::STATE1, dofs_, globdat);
+  StateVector::store(uNew_, jive::model::STATE0, dofs_, globdat);
+  StateVector::store(vNew_, jive::model::STATE1, dofs_, globdat);
 
   /////////////////////////////////////////////////
   ////////  step size adaption
   /////////////////////////////////////////////////
   correction = 0.;
-  correction += getQuality(u_pre, u_new);
-  correction += getQuality(v_pre, v_new) * dtime_;
+  correction += getQuality(uPre_, uNew_);
+  correction += getQuality(vPre_, vNew_) * dtime_;
 
   info.set(SolverInfo::RESIDUAL, 0.5 * correction);
 }
@@ -120,23 +106,47 @@ void MilneDeviceModule::solve(const Properties &info, const Properties &globdat)
 //-----------------------------------------------------------------------
 //   updForce
 //-----------------------------------------------------------------------
-Vector
-MilneDeviceModule::updForce(const Vector &fint,
-                            const Vector &fext,
-                            const Properties &globdat)
+void MilneDeviceModule::updForce(const Vector &fres,
+                                 const Properties &globdat)
+{
+  // update the internal force vector for this configuration
+  fint_ = 0.0;
+
+  model_->takeAction(Actions::GET_INT_VECTOR, updParams_, globdat);
+
+  fres = fext_ - fint_;
+}
+
+//-----------------------------------------------------------------------
+//   initParams_
+//-----------------------------------------------------------------------
+
+void MilneDeviceModule::initParams_()
 {
   Properties params;
 
-  // update the internal force vector for this configuration
-  fint = 0.0;
+  Super::initParams_();
 
-  params.set(ActionParams::INT_VECTOR, fint);
+  params.set(ActionParams::INT_VECTOR, fint_);
   if (mode_ == CONSISTENT)
     params.set(ActionParams::MATRIX2, solver_->getMatrix());
 
-  model_->takeAction(Actions::GET_INT_VECTOR, params, globdat);
+  updParams_ = params;
+}
+
+//-----------------------------------------------------------------------
+//   initWork_
+//-----------------------------------------------------------------------
+
+void MilneDeviceModule::initWork_()
+{
+  const idx_t dofCount = dofs_->dofCount();
+
+  Super::initWork_();
 
-  return Vector(fext - fint);
+  resizeWork_(uPre_, dofCount);
+  resizeWork_(vPre_, dofCount);
+  resizeWork_(aPre_, dofCount);
 }
 
 //-----------------------------------------------------------------------
@@ -66,15 +66,18 @@ public:
 
 protected:
   /// @brief Update forces for corrector step
-  /// @param fint Internal force vector (modified)
-  /// @param fext External force vector
+  /// @param fres Resulting force vector, external - internal (output)
   /// @param globdat Global data container
-  /// @return Resulting force vector (external - internal)
   /// @details In the corrector step, only internal forces change due to
-  /// updated displacement field, so external forces remain constant
-  Vector updForce(const Vector &fint,
-                  const Vector &fext,
-                  const Properties &globdat);
+  /// updated displacement field, so external forces (fext_) remain constant
+  void updForce(const Vector &fres,
+                const Properties &globdat);
+
+  /// @brief Size the predictor work arrays in addition to the base ones
+  virtual void initWork_() override;
+
+  /// @brief Bind the internal force to the corrector parameters as well
+  virtual void initParams_() override;
 
 private:
   /// @name Adams-Moulton corrector methods
@@ -94,6 +97,16 @@ private:
   /// @details Implements backward Euler: Δy = Δt * f_prev
   inline void AMupdate_(const Vector &delta_y, const Vector &f_pre) const;
   /// @}
+
+private:
+  /// @name Predictor work arrays
+  /// @{
+  Vector uPre_; ///< Predicted displacements
+  Vector vPre_; ///< Predicted velocities
+  Vector aPre_; ///< Predicted accelerations
+  /// @}
+
+  Properties updParams_; ///< Parameters of the corrector force update
 };
 
 //=======================================================================
@@ -38,9 +38,10 @@ void declareModules()
   TangentOutputModule::declare(); // Tangent stiffness homogenization
 
   // Register time integration modules
-  LeapFrogModule::declare();      // Leap-frog explicit integration
-  MilneDeviceModule::declare();   // Milne predictor-corrector method
-  EmbeddedRKModule::declare();    // Embedded Runge-Kutta methods
-  AdaptiveStepModule::declare();  // Adaptive time stepping
-  LenientNonlinModule::declare(); // Lenient nonlinear solver
+  LeapFrogModule::declare();         // Leap-frog explicit integration
+  MilneDeviceModule::declare();      // Milne predictor-corrector method
+  EmbeddedRKModule::declare();       // Embedded Runge-Kutta methods
+  AdaptiveStepModule::declare();     // Adaptive time stepping
+  LenientNonlinModule::declare();    // Lenient nonlinear solver
+  MatrixFreeNonlinModule::declare(); // Matrix-free Newton-Krylov solver
 }
@@ -24,6 +24,7 @@
 #include "modules/EmbeddedRKModule.h"
 #include "modules/LeapFrogModule.h"
 #include "modules/LenientNonlinModule.h"
+#include "modules/MatrixFreeNonlinModule.h"
 #include "modules/MilneDeviceModule.h"
 
 // I/O and visualization modules
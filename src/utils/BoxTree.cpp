@@ -0,0 +1,299 @@
+/**
+ * @file BoxTree.cpp
+ * @author Til Gärtner
+ * @brief bounding volume hierarchy of axis-aligned boxes
+ *
+ */
+#include "utils/BoxTree.h"
+
+#include <jem/base/Error.h>
+#include <jem/base/utilities.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace jive_helpers
+{
+  //-----------------------------------------------------------------------
+  //   constructor
+  //-----------------------------------------------------------------------
+
+  BoxTree::BoxTree(const idx_t leafSize)
+  {
+    JEM_PRECHECK2(leafSize > 0, "leaf size must be positive");
+
+    leafSize_ = leafSize;
+    rank_ = 0;
+    nodeCount_ = 0;
+    buildLooseness_ = 0.;
+  }
+
+  //-----------------------------------------------------------------------
+  //   build
+  //-----------------------------------------------------------------------
+
+  void BoxTree::build(const Matrix &boxes)
+  {
+    JEM_PRECHECK2(boxes.size(0) % 2 == 0, "boxes need a lower and upper corner");
+
+    const idx_t itemCount = boxes.size(1);
+
+    rank_ = boxes.size(0) / 2;
+    boxes_.resize(boxes.shape());
+    boxes_ = boxes;
+
+    Matrix centers(rank_, itemCount);
+    for (idx_t item = 0; item < itemCount; item++)
+      for (idx_t i = 0; i < rank_; i++)
+        centers(i, item) = 0.5 * (boxes(i, item) + boxes(rank_ + i, item));
+
+    // a binary tree with single-item leaves has at most 2n - 1 nodes
+    const idx_t maxNodes = jem::max(2 * itemCount - 1, (idx_t)1);
+
+    items_.resize(itemCount);
+    items_ = jem::iarray(itemCount);
+    nodeChild_.resize(maxNodes);
+    nodeBegin_.resize(maxNodes);
+    nodeEnd_.resize(maxNodes);
+    nodeBoxes_.resize(2 * rank_, maxNodes);
+
+    nodeCount_ = 1;
+    buildNode_(0, 0, itemCount, centers);
+
+    refit_();
+    buildLooseness_ = getLooseness_();
+  }
+
+  //-----------------------------------------------------------------------
+  //   update
+  //-----------------------------------------------------------------------
+
+  void BoxTree::update(const Matrix &boxes)
+  {
+    if (nodeCount_ == 0 || boxes.size(0) != 2 * rank_ ||
+        boxes.size(1) != itemCount())
+    {
+      build(boxes);
+      return;
+    }
+
+    boxes_ = boxes;
+    refit_();
+
+    if (getLooseness_() > 2. * buildLooseness_)
+      build(boxes);
+  }
+
+  //-----------------------------------------------------------------------
+  //   findOverlaps
+  //-----------------------------------------------------------------------
+
+  void BoxTree::findOverlaps(jem::util::ArrayBuffer<idx_t> &itemsA,
+                             jem::util::ArrayBuffer<idx_t> &itemsB) const
+  {
+    if (itemCount() < 2)
+      return;
+
+    // pairs of nodes still to be tested against each other
+    std::vector<idx_t> stack = {0, 0};
+
+    while (stack.size())
+    {
+      const idx_t nodeB = stack.back();
+      stack.pop_back();
+      const idx_t nodeA = stack.back();
+      stack.pop_back();
+
+      const idx_t childA = nodeChild_[nodeA];
+      const idx_t childB = nodeChild_[nodeB];
+
+      if (nodeA == nodeB)
+      {
+        if (childA >= 0)
+        {
+          stack.insert(stack.end(), {childA, childA,
+                                     childA + 1, childA + 1,
+                                     childA, childA + 1});
+          continue;
+        }
+
+        for (idx_t i = nodeBegin_[nodeA]; i < nodeEnd_[nodeA]; i++)
+          for (idx_t j = i + 1; j < nodeEnd_[nodeA]; j++)
+            if (overlap_(boxes_, items_[i], boxes_, items_[j]))
+            {
+              itemsA.pushBack(jem::min(items_[i], items_[j]));
+              itemsB.pushBack(jem::max(items_[i], items_[j]));
+            }
+        continue;
+      }
+
+      if (!overlap_(nodeBoxes_, nodeA, nodeBoxes_, nodeB))
+        continue;
+
+      if (childA < 0 && childB < 0)
+      {
+        for (idx_t i = nodeBegin_[nodeA]; i < nodeEnd_[nodeA]; i++)
+          for (idx_t j = nodeBegin_[nodeB]; j < nodeEnd_[nodeB]; j++)
+            if (overlap_(boxes_, items_[i], boxes_, items_[j]))
+            {
+              itemsA.pushBack(jem::min(items_[i], items_[j]));
+              itemsB.pushBack(jem::max(items_[i], items_[j]));
+            }
+        continue;
+      }
+
+      // descend into the larger of the two nodes
+      const idx_t sizeA = nodeEnd_[nodeA] - nodeBegin_[nodeA];
+      const idx_t sizeB = nodeEnd_[nodeB] - nodeBegin_[nodeB];
+
+      if (childB < 0 || (childA >= 0 && sizeA >= sizeB))
+        stack.insert(stack.end(), {childA, nodeB, childA + 1, nodeB});
+      else
+        stack.insert(stack.end(), {nodeA, childB, nodeA, childB + 1});
+    }
+  }
+
+  void BoxTree::findOverlaps(jem::util::ArrayBuffer<idx_t> &items,
+                             const Vector &box) const
+  {
+    JEM_PRECHECK2(box.size() == 2 * rank_, "query box does not match the tree");
+
+    if (itemCount() == 0)
+      return;
+
+    Matrix query(2 * rank_, 1);
+    query[0] = box;
+
+    std::vector<idx_t> stack = {0};
+
+    while (stack.size())
+    {
+      const idx_t inode = stack.back();
+      stack.pop_back();
+
+      if (!overlap_(nodeBoxes_, inode, query, 0))
+        continue;
+
+      if (nodeChild_[inode] >= 0)
+      {
+        stack.push_back(nodeChild_[inode]);
+        stack.push_back(nodeChild_[inode] + 1);
+        continue;
+      }
+
+      for (idx_t i = nodeBegin_[inode]; i < nodeEnd_[inode]; i++)
+        if (overlap_(boxes_, items_[i], query, 0))
+          items.pushBack(items_[i]);
+    }
+  }
+
+  //-----------------------------------------------------------------------
+  //   buildNode_
+  //-----------------------------------------------------------------------
+
+  void BoxTree::buildNode_(const idx_t inode,
+                           const idx_t begin,
+                           const idx_t end,
+                           const Matrix &centers)
+  {
+    nodeBegin_[inode] = begin;
+    nodeEnd_[inode] = end;
+
+    if (end - begin <= leafSize_)
+    {
+      nodeChild_[inode] = -1;
+      return;
+    }
+
+    // split along the longest axis of the item centers
+    idx_t axis = 0;
+    double extent = -1.;
+
+    for (idx_t i = 0; i < rank_; i++)
+    {
+      double lo = centers(i, items_[begin]);
+      double hi = lo;
+
+      for (idx_t k = begin + 1; k < end; k++)
+      {
+        lo = jem::min(lo, centers(i, items_[k]));
+        hi = jem::max(hi, centers(i, items_[k]));
+      }
+
+      if (hi - lo > extent)
+      {
+        extent = hi - lo;
+        axis = i;
+      }
+    }
+
+    const idx_t mid = (begin + end) / 2;
+    idx_t *items = items_.addr();
+
+    std::nth_element(items + begin, items + mid, items + end,
+                     [&centers, axis](idx_t a, idx_t b)
+                     { return centers(axis, a) < centers(axis, b); });
+
+    // children are stored consecutively and always after their parent
+    const idx_t child = nodeCount_;
+    nodeCount_ += 2;
+    nodeChild_[inode] = child;
+
+    buildNode_(child, begin, mid, centers);
+    buildNode_(child + 1, mid, end, centers);
+  }
+
+  //-----------------------------------------------------------------------
+  //   refit_
+  //-----------------------------------------------------------------------
+
+  void BoxTree::refit_()
+  {
+    if (itemCount() == 0)
+      return;
+
+    for (idx_t inode = nodeCount_ - 1; inode >= 0; inode--)
+    {
+      const idx_t child = nodeChild_[inode];
+
+      if (child >= 0)
+      {
+        for (idx_t i = 0; i < rank_; i++)
+        {
+          nodeBoxes_(i, inode) =
+              jem::min(nodeBoxes_(i, child), nodeBoxes_(i, child + 1));
+          nodeBoxes_(rank_ + i, inode) =
+              jem::max(nodeBoxes_(rank_ + i, child),
+                       nodeBoxes_(rank_ + i, child + 1));
+        }
+        continue;
+      }
+
+      nodeBoxes_[inode] = boxes_[items_[nodeBegin_[inode]]];
+
+      for (idx_t k = nodeBegin_[inode] + 1; k < nodeEnd_[inode]; k++)
+        for (idx_t i = 0; i < rank_; i++)
+        {
+          nodeBoxes_(i, inode) =
+              jem::min(nodeBoxes_(i, inode), boxes_(i, items_[k]));
+          nodeBoxes_(rank_ + i, inode) =
+              jem::max(nodeBoxes_(rank_ + i, inode), boxes_(rank_ + i, items_[k]));
+        }
+    }
+  }
+
+  //-----------------------------------------------------------------------
+  //   getLooseness_
+  //-----------------------------------------------------------------------
+
+  double BoxTree::getLooseness_() const
+  {
+    double sum = 0.;
+
+    for (idx_t inode = 0; inode < nodeCount_; inode++)
+      for (idx_t i = 0; i < rank_; i++)
+        sum += nodeBoxes_(rank_ + i, inode) - nodeBoxes_(i, inode);
+
+    return sum;
+  }
+} // namespace jive_helpers
@@ -0,0 +1,97 @@
+/**
+ * @file BoxTree.h
+ * @author Til Gärtner
+ * @brief bounding volume hierarchy of axis-aligned boxes
+ *
+ * The tree is built once from a set of item boxes by splitting the items at
+ * the median of their centers along the longest axis. When the boxes move,
+ * the tree is refit bottom-up while the topology is kept. It is only rebuilt
+ * once the refit boxes have grown too loose compared to the last build.
+ */
+#pragma once
+
+#include "utils/helpers.h"
+
+#include <jem/util/ArrayBuffer.h>
+
+namespace jive_helpers
+{
+  /**
+   * @class BoxTree
+   * @brief binary tree of axis-aligned bounding boxes
+   *
+   * Boxes are stored one per column. The first rank rows hold the lower
+   * corner and the last rank rows the upper corner of the box.
+   */
+  class BoxTree
+  {
+  public:
+    /// @brief Constructor
+    /// @param leafSize maximum number of items in a leaf
+    explicit BoxTree(const idx_t leafSize = 4);
+
+    /// @brief build the tree topology and the node boxes
+    /// @param boxes item boxes (2*rank x itemCount)
+    void build(const Matrix &boxes);
+
+    /// @brief refit the node boxes to moved item boxes
+    /// @details the tree is rebuilt if it has not been built for the same
+    /// number of items yet or if the refit boxes got too loose
+    /// @param boxes item boxes (2*rank x itemCount)
+    void update(const Matrix &boxes);
+
+    /// @brief find all pairs of items with overlapping boxes
+    /// @param[out] itemsA first item of every pair
+    /// @param[out] itemsB second item of every pair (itemsA[i] < itemsB[i])
+    void findOverlaps(jem::util::ArrayBuffer<idx_t> &itemsA,
+                      jem::util::ArrayBuffer<idx_t> &itemsB) const;
+
+    /// @brief find all items overlapping a given box
+    /// @param[out] items items overlapping the box
+    /// @param[in] box query box (2*rank)
+    void findOverlaps(jem::util::ArrayBuffer<idx_t> &items,
+                      const Vector &box) const;
+
+    /// @return number of items in the tree
+    inline idx_t itemCount() const
+    {
+      return boxes_.size(1);
+    }
+
+  private:
+    void buildNode_(const idx_t inode,
+                    const idx_t begin,
+                    const idx_t end,
+                    const Matrix &centers);
+
+    void refit_();
+
+    double getLooseness_() const;
+
+    inline bool overlap_(const Matrix &boxesA,
+                         const idx_t iA,
+                         const Matrix &boxesB,
+                         const idx_t iB) const
+    {
+      for (idx_t i = 0; i < rank_; i++)
+        if (boxesA(i, iA) > boxesB(rank_ + i, iB) ||
+            boxesB(i, iB) > boxesA(rank_ + i, iA))
+          return false;
+      return true;
+    }
+
+  private:
+    idx_t leafSize_;
+    idx_t rank_;
+    idx_t nodeCount_;
+
+    Matrix boxes_;        ///< current item boxes
+    Matrix nodeBoxes_;    ///< node boxes
+    IdxVector items_;     ///< items ordered by leaf
+    IdxVector nodeChild_; ///< first of two consecutive children (-1 for leaves)
+    IdxVector nodeBegin_; ///< first item of a node in items_
+    IdxVector nodeEnd_;   ///< one past the last item of a node in items_
+
+    double buildLooseness_; ///< summed node box extents after the last build
+  };
+} // namespace jive_helpers
@@ -13,8 +13,14 @@ const char *SolverNames::N_CONTINUES = "NContinues";
 const char *SolverNames::STEP_SIZE = "StepSize";
 const char *SolverNames::STEP_SIZE_0 = "StepSize0";
 const char *SolverNames::TERMINATE = "Terminate";
+const char *SolverNames::TANGENT_OPERATOR = "TangentOperator";
+const char *SolverNames::STABLE_STEP_SIZE = "StableStepSize";
+const char *SolverNames::STEP_LEVEL = "StepLevel";
+const char *SolverNames::MAX_STEP_LEVEL = "MaxStepLevel";
 
 // actions
 const char *SolverNames::CHECK_COMMIT = "CheckCommit";
 const char *SolverNames::SET_STEP_SIZE = "SetStepSize";
 const char *SolverNames::CONTINUE = "Continue";
+const char *SolverNames::GET_TANGENT_OPERATOR = "GetTangentOperator";
+const char *SolverNames::GET_STABLE_STEP_SIZE = "GetStableStepSize";
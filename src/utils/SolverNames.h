@@ -15,9 +15,15 @@ struct SolverNames
   static const char *STEP_SIZE;
   static const char *STEP_SIZE_0;
   static const char *TERMINATE;
+  static const char *TANGENT_OPERATOR;
+  static const char *STABLE_STEP_SIZE;
+  static const char *STEP_LEVEL;
+  static const char *MAX_STEP_LEVEL;
 
   // actions
   static const char *CHECK_COMMIT;
   static const char *SET_STEP_SIZE;
   static const char *CONTINUE;
+  static const char *GET_TANGENT_OPERATOR;
+  static const char *GET_STABLE_STEP_SIZE;
 };
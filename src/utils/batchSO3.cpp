@@ -0,0 +1,123 @@
+/**
+ * @file batchSO3.cpp
+ * @author Til Gärtner
+ * @brief batched SO(3) kernels in structure-of-arrays layout
+ *
+ */
+#include "utils/batchSO3.h"
+
+#include <jem/base/utilities.h>
+
+#include <math.h>
+
+namespace jive_helpers
+{
+  void expVecBatch(const Matrix &R, const Matrix &psi)
+  {
+    const idx_t count = psi.size(0);
+
+    JEM_ASSERT2(psi.size(1) == 3 && R.size(0) == count && R.size(1) == 9,
+                "rotation arrays do not match");
+    JEM_ASSERT2(psi.stride(0) == 1 && R.stride(0) == 1,
+                "rotation arrays need to be contiguous per component");
+
+    const double *x = &psi(0, 0);
+    const double *y = &psi(0, 1);
+    const double *z = &psi(0, 2);
+    double *r[9];
+
+    for (idx_t i = 0; i < 9; i++)
+      r[i] = &R(0, i);
+
+#pragma omp simd
+    for (idx_t k = 0; k < count; k++)
+    {
+      const double th2 = x[k] * x[k] + y[k] * y[k] + z[k] * z[k];
+      const double th = sqrt(th2);
+      const bool tiny = jem::isTiny(th);
+      // R = I + a [psi x] + b [psi x]^2 (infinitesimal rotation for tiny th)
+      const double a = tiny ? 1. : sin(th) / th;
+      const double b = tiny ? 0. : (1. - cos(th)) / th2;
+
+      r[0][k] = 1. + b * (x[k] * x[k] - th2);
+      r[1][k] = a * z[k] + b * x[k] * y[k];
+      r[2][k] = -a * y[k] + b * x[k] * z[k];
+      r[3][k] = -a * z[k] + b * x[k] * y[k];
+      r[4][k] = 1. + b * (y[k] * y[k] - th2);
+      r[5][k] = a * x[k] + b * y[k] * z[k];
+      r[6][k] = a * y[k] + b * x[k] * z[k];
+      r[7][k] = -a * x[k] + b * y[k] * z[k];
+      r[8][k] = 1. + b * (z[k] * z[k] - th2);
+    }
+  }
+
+  void logMatBatch(const Matrix &psi, const Matrix &R)
+  {
+    const idx_t count = R.size(0);
+
+    JEM_ASSERT2(R.size(1) == 9 && psi.size(0) == count && psi.size(1) == 3,
+                "rotation arrays do not match");
+    JEM_ASSERT2(psi.stride(0) == 1 && R.stride(0) == 1,
+                "rotation arrays need to be contiguous per component");
+
+    double *x = &psi(0, 0);
+    double *y = &psi(0, 1);
+    double *z = &psi(0, 2);
+    const double *r[9];
+
+    for (idx_t i = 0; i < 9; i++)
+      r[i] = &R(0, i);
+
+#pragma omp simd
+    for (idx_t k = 0; k < count; k++)
+    {
+      const double tr = r[0][k] + r[4][k] + r[8][k];
+      const double tr_R = tr <= 3. ? tr : 3.;
+      const double th = acos((tr_R - 1.) / 2.);
+      const double fact = jem::isTiny(th) ? 1 / 2. // infinitesimal rotation
+                                          : th / (2. * sin(th));
+
+      x[k] = fact * (r[5][k] - r[7][k]);
+      y[k] = fact * (r[6][k] - r[2][k]);
+      z[k] = fact * (r[1][k] - r[3][k]);
+    }
+  }
+
+  void composeBatch(const Matrix &R, const Matrix &A, const Matrix &B)
+  {
+    const idx_t count = R.size(0);
+
+    JEM_ASSERT2(R.size(1) == 9 && A.size(0) == count && A.size(1) == 9 &&
+                    B.size(0) == count && B.size(1) == 9,
+                "rotation arrays do not match");
+    JEM_ASSERT2(R.stride(0) == 1 && A.stride(0) == 1 && B.stride(0) == 1,
+                "rotation arrays need to be contiguous per component");
+
+    double *r[9];
+    const double *a[9];
+    const double *b[9];
+
+    for (idx_t i = 0; i < 9; i++)
+    {
+      r[i] = &R(0, i);
+      a[i] = &A(0, i);
+      b[i] = &B(0, i);
+    }
+
+    for (idx_t j = 0; j < 3; j++)
+      for (idx_t i = 0; i < 3; i++)
+      {
+        double *rij = r[i + 3 * j];
+        const double *ai0 = a[i + 0];
+        const double *ai1 = a[i + 3];
+        const double *ai2 = a[i + 6];
+        const double *b0j = b[0 + 3 * j];
+        const double *b1j = b[1 + 3 * j];
+        const double *b2j = b[2 + 3 * j];
+
+#pragma omp simd
+        for (idx_t k = 0; k < count; k++)
+          rij[k] = ai0[k] * b0j[k] + ai1[k] * b1j[k] + ai2[k] * b2j[k];
+      }
+  }
+} // namespace jive_helpers
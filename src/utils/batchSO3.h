@@ -0,0 +1,47 @@
+/**
+ * @file batchSO3.h
+ * @author Til Gärtner
+ * @brief batched SO(3) kernels in structure-of-arrays layout
+ *
+ * These functions evaluate the exponential map, the logarithmic map and
+ * the composition of many rotations at once. All arrays store one rotation
+ * per row and one component per column, so every component is contiguous
+ * in memory (column-major jem storage) and the loops over the rotations can
+ * be evaluated in SIMD lanes. Rotation matrices use nine columns, where the
+ * entry (i,j) is stored in column i + 3*j.
+ */
+#pragma once
+
+#include "utils/helpers.h"
+
+namespace jive_helpers
+{
+  /**
+   * @brief batched exponential map of axial rotation vectors.
+   *
+   * @see jive_helpers::expVec
+   *
+   * @param[out] R rotation matrices (count x 9)
+   * @param[in] psi axial rotation vectors (count x 3)
+   */
+  void expVecBatch(const Matrix &R, const Matrix &psi);
+
+  /**
+   * @brief batched logarithmic map of rotation matrices.
+   *
+   * @see jive_helpers::logMat
+   *
+   * @param[out] psi axial rotation vectors (count x 3)
+   * @param[in] R rotation matrices (count x 9)
+   */
+  void logMatBatch(const Matrix &psi, const Matrix &R);
+
+  /**
+   * @brief batched composition of rotation matrices.
+   *
+   * @param[out] R products A * B (count x 9, must not alias A or B)
+   * @param[in] A left rotation matrices (count x 9)
+   * @param[in] B right rotation matrices (count x 9)
+   */
+  void composeBatch(const Matrix &R, const Matrix &A, const Matrix &B);
+} // namespace jive_helpers
@@ -0,0 +1,357 @@
+/**
+ * @file fixedAlgebra.h
+ * @author Til Gärtner
+ * @brief fixed-size 3-vector, 3x3 and 6x6 kernels for the rod hot path
+ *
+ * All types live on the stack and all sizes are known at compile time, so
+ * these kernels never allocate and can be inlined and vectorized by the
+ * compiler. The jem array versions in helpers.h forward to these kernels.
+ */
+#pragma once
+
+#include "utils/helpers.h"
+
+#include <jem/base/Tuple.h>
+
+#include <math.h>
+
+namespace jive_helpers
+{
+  typedef jem::Tuple<double, 3> Vec3;    ///< fixed-size 3-vector
+  typedef jem::Tuple<double, 3, 3> Mat3; ///< fixed-size 3x3 matrix
+  typedef jem::Tuple<double, 6, 6> Mat6; ///< fixed-size 6x6 matrix
+
+  /**
+   * @brief copy a jem vector of size 3 into a fixed-size vector.
+   *
+   * @param[out] res fixed-size vector
+   * @param[in] vec jem vector
+   */
+  inline void load(Vec3 &res, const Vector &vec)
+  {
+    for (int i = 0; i < 3; i++)
+      res[i] = vec[i];
+  }
+
+  /**
+   * @brief copy a jem 3x3 matrix into a fixed-size matrix.
+   *
+   * @param[out] res fixed-size matrix
+   * @param[in] mat jem matrix
+   */
+  inline void load(Mat3 &res, const Matrix &mat)
+  {
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        res(i, j) = mat(i, j);
+  }
+
+  /**
+   * @brief copy a jem 6x6 matrix into a fixed-size matrix.
+   *
+   * @param[out] res fixed-size matrix
+   * @param[in] mat jem matrix
+   */
+  inline void load(Mat6 &res, const Matrix &mat)
+  {
+    for (int j = 0; j < 6; j++)
+      for (int i = 0; i < 6; i++)
+        res(i, j) = mat(i, j);
+  }
+
+  /**
+   * @brief copy a fixed-size vector into a jem vector of size 3.
+   *
+   * @param[out] res jem vector
+   * @param[in] vec fixed-size vector
+   */
+  inline void store(const Vector &res, const Vec3 &vec)
+  {
+    for (int i = 0; i < 3; i++)
+      res[i] = vec[i];
+  }
+
+  /**
+   * @brief copy a fixed-size matrix into a jem 3x3 matrix.
+   *
+   * @param[out] res jem matrix
+   * @param[in] mat fixed-size matrix
+   */
+  inline void store(const Matrix &res, const Mat3 &mat)
+  {
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        res(i, j) = mat(i, j);
+  }
+
+  /**
+   * @brief copy a fixed-size matrix into a jem 6x6 matrix.
+   *
+   * @param[out] res jem matrix
+   * @param[in] mat fixed-size matrix
+   */
+  inline void store(const Matrix &res, const Mat6 &mat)
+  {
+    for (int j = 0; j < 6; j++)
+      for (int i = 0; i < 6; i++)
+        res(i, j) = mat(i, j);
+  }
+
+  /**
+   * @brief set a fixed-size matrix to the identity.
+   *
+   * @param[out] res identity matrix
+   */
+  inline void setEye(Mat3 &res)
+  {
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        res(i, j) = i == j ? 1. : 0.;
+  }
+
+  /**
+   * @brief 2-norm of a fixed-size vector.
+   *
+   * @param vec vector
+   * @returns Euclidean norm of the vector
+   */
+  inline double vec3Norm(const Vec3 &vec)
+  {
+    return sqrt(vec[0] * vec[0] + vec[1] * vec[1] + vec[2] * vec[2]);
+  }
+
+  /**
+   * @brief matrix product of two fixed-size matrices.
+   *
+   * @param[out] res A * B (must not alias A or B)
+   * @param[in] A left matrix
+   * @param[in] B right matrix
+   */
+  inline void mat3Mul(Mat3 &res, const Mat3 &A, const Mat3 &B)
+  {
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        res(i, j) = A(i, 0) * B(0, j) + A(i, 1) * B(1, j) + A(i, 2) * B(2, j);
+  }
+
+  /**
+   * @brief matrix product with the transpose of the first matrix.
+   *
+   * @param[out] res A^T * B (must not alias A or B)
+   * @param[in] A left matrix (transposed)
+   * @param[in] B right matrix
+   */
+  inline void mat3TMul(Mat3 &res, const Mat3 &A, const Mat3 &B)
+  {
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        res(i, j) = A(0, i) * B(0, j) + A(1, i) * B(1, j) + A(2, i) * B(2, j);
+  }
+
+  /**
+   * @brief product of a fixed-size matrix with a fixed-size vector.
+   *
+   * @param[out] res A * v (must not alias v)
+   * @param[in] A matrix
+   * @param[in] v vector
+   */
+  inline void mat3Vec(Vec3 &res, const Mat3 &A, const Vec3 &v)
+  {
+    for (int i = 0; i < 3; i++)
+      res[i] = A(i, 0) * v[0] + A(i, 1) * v[1] + A(i, 2) * v[2];
+  }
+
+  /**
+   * @brief product of a transposed fixed-size matrix with a vector.
+   *
+   * @param[out] res A^T * v (must not alias v)
+   * @param[in] A matrix (transposed)
+   * @param[in] v vector
+   */
+  inline void mat3TVec(Vec3 &res, const Mat3 &A, const Vec3 &v)
+  {
+    for (int i = 0; i < 3; i++)
+      res[i] = A(0, i) * v[0] + A(1, i) * v[1] + A(2, i) * v[2];
+  }
+
+  /**
+   * @brief construct a skew symmetric matrix from a given vector.
+   *
+   * @param[out] res skew symmetric matrix
+   * @param[in] vec axial vector
+   */
+  inline void skew(Mat3 &res, const Vec3 &vec)
+  {
+    res(0, 0) = 0.;
+    res(1, 0) = 1 * vec[2];
+    res(2, 0) = -1 * vec[1];
+    res(0, 1) = -1 * vec[2];
+    res(1, 1) = 0.;
+    res(2, 1) = 1 * vec[0];
+    res(0, 2) = 1 * vec[1];
+    res(1, 2) = -1 * vec[0];
+    res(2, 2) = 0.;
+  }
+
+  /**
+   * @brief construct the axial vector of a skew symmetric matrix.
+   *
+   * @param[out] res axial vector
+   * @param[in] mat skew symmetric matrix
+   */
+  inline void unskew(Vec3 &res, const Mat3 &mat)
+  {
+    res[0] = (mat(2, 1) - mat(1, 2)) / 2.;
+    res[1] = (mat(0, 2) - mat(2, 0)) / 2.;
+    res[2] = (mat(1, 0) - mat(0, 1)) / 2.;
+  }
+
+  /**
+   * @brief compute the exponential of an axial vector.
+   *
+   * @see jive_helpers::expVec(const Matrix &, const Vector &)
+   *
+   * @param[out] Exp resulting matrix exponential
+   * @param[in] psi axial rotation vector
+   */
+  inline void expVec(Mat3 &Exp, const Vec3 &psi)
+  {
+    const double theta = vec3Norm(psi);
+    Mat3 K;
+
+    setEye(Exp);
+
+    if (jem::isTiny(theta))
+    {
+      skew(K, psi); // infinitesimal rotation
+      for (int j = 0; j < 3; j++)
+        for (int i = 0; i < 3; i++)
+          Exp(i, j) += K(i, j);
+    }
+    else
+    {
+      const double s = sin(theta);
+      const double c = 1 - cos(theta);
+      Vec3 k;
+      Mat3 KK;
+
+      for (int i = 0; i < 3; i++)
+        k[i] = psi[i] / theta;
+
+      skew(K, k);
+      mat3Mul(KK, K, K);
+
+      for (int j = 0; j < 3; j++)
+        for (int i = 0; i < 3; i++)
+          Exp(i, j) += s * K(i, j) + c * KK(i, j);
+    }
+  }
+
+  /**
+   * @brief derivative of the exponential of an axial vector.
+   *
+   * @see jive_helpers::expVecP(const Matrix &, const Vector &, const Vector &)
+   *
+   * @param[out] ExpP derivative of the matrix exponential
+   * @param[in] psi axial rotation vector
+   * @param[in] psiP derivative of the axial rotation vector
+   */
+  inline void expVecP(Mat3 &ExpP, const Vec3 &psi, const Vec3 &psiP)
+  {
+    const double theta = vec3Norm(psi);
+
+    if (theta < TINY)
+    {
+      skew(ExpP, psiP);
+      return;
+    }
+
+    // derivative of norm
+    const double thetaP =
+        (psi[0] * psiP[0] + psi[1] * psiP[1] + psi[2] * psiP[2]) / theta;
+    const double s = sin(theta);
+    const double c = cos(theta);
+
+    Vec3 k;
+    Vec3 kP;
+    Mat3 K;
+    Mat3 KP;
+    Mat3 KK;
+    Mat3 KKP;
+    Mat3 KPK;
+
+    for (int i = 0; i < 3; i++)
+    {
+      k[i] = psi[i] / theta;
+      // Quotient rule
+      kP[i] = (psiP[i] * theta - psi[i] * thetaP) / theta / theta;
+    }
+
+    skew(K, k);
+    skew(KP, kP);
+    mat3Mul(KK, K, K);
+    mat3Mul(KKP, K, KP);
+    mat3Mul(KPK, KP, K);
+
+    for (int j = 0; j < 3; j++)
+      for (int i = 0; i < 3; i++)
+        ExpP(i, j) = c * thetaP * K(i, j) + s * KP(i, j) +
+                     s * thetaP * KK(i, j) +
+                     (1 - c) * (KKP(i, j) + KPK(i, j));
+  }
+
+  /**
+   * @brief compute the rotational vector of a rotation matrix.
+   *
+   * @see jive_helpers::logMat(const Vector &, const Matrix &)
+   *
+   * @param[out] rv rotational vector
+   * @param[in] R rotation matrix
+   */
+  inline void logMat(Vec3 &rv, const Mat3 &R)
+  {
+    const double tr = R(0, 0) + R(1, 1) + R(2, 2);
+    const double tr_R = tr <= 3. ? tr : 3.;
+    const double theta = acos((tr_R - 1.) / 2.);
+
+    rv[0] = R(2, 1) - R(1, 2);
+    rv[1] = R(0, 2) - R(2, 0);
+    rv[2] = R(1, 0) - R(0, 1);
+
+    const double fact = jem::isTiny(theta) ? 1 / 2. // infinitesimal rotation
+                                           : theta / (2. * sin(theta));
+    for (int i = 0; i < 3; i++)
+      rv[i] *= fact;
+  }
+
+  /**
+   * @brief push a 6x6 material matrix forward into the spatial frame.
+   *
+   * Computes PI * C * PI^T for PI = diag(R, R) block by block.
+   *
+   * @param[out] res spatial matrix (must not alias C)
+   * @param[in] R rotation matrix
+   * @param[in] C material matrix
+   */
+  inline void pushForward(Mat6 &res, const Mat3 &R, const Mat6 &C)
+  {
+    Mat3 tmp;
+
+    for (int bi = 0; bi < 2; bi++)
+      for (int bj = 0; bj < 2; bj++)
+      {
+        // tmp = C_ij * R^T
+        for (int j = 0; j < 3; j++)
+          for (int i = 0; i < 3; i++)
+            tmp(i, j) = C(3 * bi + i, 3 * bj + 0) * R(j, 0) +
+                        C(3 * bi + i, 3 * bj + 1) * R(j, 1) +
+                        C(3 * bi + i, 3 * bj + 2) * R(j, 2);
+        // res_ij = R * tmp
+        for (int j = 0; j < 3; j++)
+          for (int i = 0; i < 3; i++)
+            res(3 * bi + i, 3 * bj + j) = R(i, 0) * tmp(0, j) +
+                                          R(i, 1) * tmp(1, j) +
+                                          R(i, 2) * tmp(2, j);
+      }
+  }
+} // namespace jive_helpers
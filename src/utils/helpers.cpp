@@ -5,6 +5,7 @@
  *
  */
 #include "utils/helpers.h"
+#include "utils/fixedAlgebra.h"
 
 namespace jive_helpers
 {
@@ -98,16 +99,12 @@ namespace jive_helpers
 
   void logMat(const Vector &rv, const Matrix &R)
   {
-    double theta;                                 // angle of rotation
-    double tr_R = trace(R) <= 3. ? trace(R) : 3.; // trace of the matrix
+    Vec3 rvFix;
+    Mat3 RFix;
 
-    theta = acos((tr_R - 1.) / 2.);
-    rv = unskew(Matrix(R - R.transpose()));
-
-    if (jem::isTiny(theta))
-      rv *= 1 / 2.; // infinitesimal rotation
-    else
-      rv *= theta / (2. * sin(theta));
+    load(RFix, R);
+    logMat(rvFix, RFix);
+    store(rv, rvFix);
   }
 
   void vec2mat(const Matrix &mat, const Vector &vec)
@@ -138,62 +135,24 @@ namespace jive_helpers
 
   void expVec(const Matrix &Exp, const Vector &psi)
   {
-    Exp = eye();
-    const double theta = norm2(psi);
-
-    if (jem::isTiny(theta))
-      Exp += skew(psi); // infinitesimal rotation
-    else
-    {
-      const Vector k(psi.size());
-      const Matrix K(psi.size(), psi.size());
-
-      k = psi / theta;
-      K = skew(k);
+    Vec3 psiFix;
+    Mat3 ExpFix;
 
-      Exp += sin(theta) * K;
-      Exp += (1 - cos(theta)) * matmul(K, K);
-    }
+    load(psiFix, psi);
+    expVec(ExpFix, psiFix);
+    store(Exp, ExpFix);
   }
 
   void expVecP(const Matrix &ExpP, const Vector &psi, const Vector &psiP)
   {
-    const double theta = norm2(psi);
+    Vec3 psiFix;
+    Vec3 psiPFix;
+    Mat3 ExpPFix;
 
-    if (theta < TINY)
-    {
-      ExpP = skew(psiP);
-      return;
-    }
-    // TEST_NO_CONTEXT(skew(psiP))
-
-    // derivative of norm
-    const double thetaP = dot(psi, psiP) / theta;
-
-    const Vector k(psi.size());
-    const Vector kP(psi.size());
-    const Matrix K(psi.size(), psi.size());
-    const Matrix KP(psi.size(), psi.size());
-
-    k = psi / theta;
-    // Quotient rule
-    kP = (psiP * theta - psi * thetaP) / theta / theta;
-
-    K = skew(k);
-    KP = skew(kP);
-
-    // Exp  = eye();
-    ExpP = 0;
-    // TEST_NO_CONTEXT(ExpP)
-    // Exp   += sin(theta) * K;
-    ExpP += cos(theta) * thetaP * K;
-    ExpP += sin(theta) * KP;
-    // TEST_NO_CONTEXT(ExpP)
-    // Exp   += (1-cos(theta)) * matmul ( K, K );
-    ExpP += sin(theta) * thetaP * matmul(K, K);
-    ExpP += (1 - cos(theta)) * matmul(K, KP);
-    ExpP += (1 - cos(theta)) * matmul(KP, K);
-    // TEST_NO_CONTEXT(ExpP)
+    load(psiFix, psi);
+    load(psiPFix, psiP);
+    expVecP(ExpPFix, psiFix, psiPFix);
+    store(ExpP, ExpPFix);
   }
 
   double trace(const Matrix &mat)
@@ -242,14 +201,12 @@ namespace jive_helpers
   Matrix skew(const Vector &vec)
   {
     Matrix res(3, 3);
-    res = 0.;
+    Vec3 vecFix;
+    Mat3 resFix;
 
-    res(0, 1) = -1 * vec[2];
-    res(0, 2) = 1 * vec[1];
-    res(1, 2) = -1 * vec[0];
-    res(1, 0) = 1 * vec[2];
-    res(2, 0) = -1 * vec[1];
-    res(2, 1) = 1 * vec[0];
+    load(vecFix, vec);
+    skew(resFix, vecFix);
+    store(res, resFix);
 
     return res;
   };
@@ -269,13 +226,12 @@ namespace jive_helpers
                 "Matrix trace not zero");
 
     Vector res(3);
-    res = 0.;
-
-    res[0] = mat(2, 1) - mat(1, 2);
-    res[1] = mat(0, 2) - mat(2, 0);
-    res[2] = mat(1, 0) - mat(0, 1);
+    Vec3 resFix;
+    Mat3 matFix;
 
-    res /= 2.;
+    load(matFix, mat);
+    unskew(resFix, matFix);
+    store(res, resFix);
 
     return res;
   }
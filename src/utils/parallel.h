@@ -0,0 +1,102 @@
+/**
+ * @file parallel.h
+ * @author Til Gärtner
+ * @brief helpers for shared-memory parallel loops
+ *
+ * The loops fall back to a plain serial loop if the code is compiled
+ * without OpenMP support (see parallel.mk).
+ */
+#pragma once
+
+#include <exception>
+
+#include <jem/base/Array.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace jive_helpers
+{
+  /**
+   * @brief get the number of threads available to parallel loops.
+   *
+   * @returns maximum number of threads (1 without OpenMP support)
+   */
+  inline jem::idx_t maxThreadCount()
+  {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  /**
+   * @brief get the index of the calling thread.
+   *
+   * Inside parallelFor the index is below the thread count of the loop, so
+   * it can select per-thread work arrays that are allocated beforehand.
+   *
+   * @returns thread index (0 outside parallel loops and without OpenMP)
+   */
+  inline jem::idx_t threadIndex()
+  {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief evaluate a function for every index in a range concurrently.
+   *
+   * The indices are distributed statically over the threads. The function
+   * must only write to data that is private to its index. The first
+   * exception thrown by any of the threads is rethrown on the calling
+   * thread after the loop has finished.
+   *
+   * @param begin first index of the range
+   * @param end one past the last index of the range
+   * @param threadCount number of threads to use (serial loop if <= 1)
+   * @param func function to be called with every index
+   */
+  template <class Func>
+  void parallelFor(const jem::idx_t begin,
+                   const jem::idx_t end,
+                   const jem::idx_t threadCount,
+                   const Func &func)
+  {
+    if (threadCount <= 1 || end - begin <= 1)
+    {
+      for (jem::idx_t i = begin; i < end; i++)
+        func(i);
+      return;
+    }
+
+    std::exception_ptr error = nullptr;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(threadCount)) schedule(static)
+#endif
+    for (jem::idx_t i = begin; i < end; i++)
+    {
+      try
+      {
+        func(i);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical(jive_helpers_parallelFor)
+#endif
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+} // namespace jive_helpers
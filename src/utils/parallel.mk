@@ -0,0 +1,16 @@
+#######################################################################
+##   Shared-memory parallelism build configuration                   ##
+##   Author: Til Gärtner                                             ##
+##   Purpose: Enable OpenMP for threaded and SIMD loops              ##
+#######################################################################
+# Default build: OpenMP enabled.
+# Serial build (all loops run on one thread, SIMD hints are kept) with:
+#   make OPENMP=0
+OPENMP ?= 1
+
+ifeq ($(OPENMP),1)
+MY_CXX_STD_FLAGS += '-fopenmp'
+MY_LIBS     += gomp
+else
+MY_CXX_STD_FLAGS += '-fopenmp-simd'
+endif
@@ -0,0 +1,52 @@
+#!/usr/bin/python3
+
+# TEST 6 3D (Test 5 with matrix-free tangents)
+import sys
+import numpy as np
+from pathlib import Path
+from termcolor import colored
+from matplotlib import pyplot as plt
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+from metrics import relative_L2
+
+TOL = 1e-3
+
+test_passed = False
+
+try:
+  sim_disp = np.loadtxt("tests/beam/test6/disp.csv", delimiter=',')
+  sim_resp = np.loadtxt("tests/beam/test6/resp.csv", delimiter=',')
+  ref_disp = np.loadtxt("tests/beam/test5/disp.csv", delimiter=',')
+  ref_resp = np.loadtxt("tests/beam/test5/resp.csv", delimiter=',')
+
+  plt.figure(figsize=(12, 4))
+  for i in range(3):
+    plt.plot(sim_resp[:, 2], sim_disp[:, i],
+             label=f"u_{i+1} (matrix-free)")
+    plt.plot(ref_resp[:, 2], ref_disp[:, i], ":",
+             label=f"u_{i+1} (assembled, Test 5)")
+  plt.legend(loc="upper left")
+  plt.xlabel("load (N)")
+  plt.ylabel("displacement (m)")
+  plt.xlim(left=0, right=3000)
+
+  # both solvers have to reach the same equilibrium in every load step
+  err_disp = relative_L2(sim_disp[:, :3], ref_disp[:, :3])
+  err_resp = relative_L2(sim_resp[:, 2], ref_resp[:, 2])
+  print(f"relative difference to the assembled solver: {err_disp}, {err_resp}")
+  test_passed = sim_disp.shape == ref_disp.shape and \
+      err_disp <= TOL and err_resp <= TOL
+
+except Exception as e:
+  print(e)
+
+if test_passed:
+  print(colored("STATIC TEST 6 PASSED", "green"))
+
+  plt.tight_layout()
+  plt.savefig("tests/beam/test6/result.pdf")
+  plt.savefig("tests/beam6_result.png")
+else:
+  print(colored("STATIC TEST 6 FAILED", "red", attrs=["bold"]))
+  sys.exit(1)
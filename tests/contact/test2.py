@@ -0,0 +1,51 @@
+#!/usr/bin/python3
+
+# two quadratic beams crossed in an X shape
+
+import sys
+import os
+import numpy as np
+from termcolor import colored
+from matplotlib import pyplot as plt
+
+TOL = 0.05
+
+test_passed = False
+
+try:
+  sim_disp = np.loadtxt("tests/contact/test2/disp.csv", delimiter=',')
+  sim_resp = np.loadtxt("tests/contact/test2/resp.csv", delimiter=',')
+
+  ref_disp = np.array([0, 0, 1e-9, 1.72e1, 3.43e1, 5.13e1, 6.84e1])
+
+  plt.figure(figsize=(16/3, 6))
+
+  plt.plot(np.sqrt(sim_resp[:, 0]**2 + sim_resp[:, 1]
+           ** 2 + sim_resp[:, 2]**2), label="custom implementation")
+  plt.plot(ref_disp, label="Zavarise et al. (2000)", linestyle="--")
+
+  plt.xlabel("iteration")
+  plt.ylabel("contact force (N)")
+
+  plt.legend()
+
+  # Settled-tail comparison: (68.4 N, Zavarise et al. 2000, Fig. 7)
+  ref_force = ref_disp[-1]
+  sim_mag = np.sqrt((sim_resp[:, 0]**2 + sim_resp[:, 1]**2 + sim_resp[:, 2]**2))
+  settled = sim_mag[int(0.95 * len(sim_mag)):]
+  sim_final = float(np.mean(settled))
+  err = abs(sim_final - ref_force) / ref_force
+  test_passed = err <= TOL
+
+except Exception as e:
+  print(e)
+
+if test_passed:
+  print(colored("CONTACT TEST 2 PASSED", "green"))
+
+  plt.tight_layout()
+  plt.savefig("tests/contact/test2/result.pdf")
+  plt.savefig("tests/contact2_result.png")
+else:
+  print(colored("CONTACT TEST 2 FAILED", "red", attrs=["bold"]))
+  sys.exit(1)
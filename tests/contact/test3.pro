@@ -0,0 +1,57 @@
+///////////////////////////////////
+//////  Self-contact of a single rod  ///////
+///////////////////////////////////
+
+// LOGGING
+log.pattern = "*.info | *.debug"; //
+
+// PROGRAM_CONTROL
+control.runWhile = "i<=6";
+
+// SOLVER
+Solver.modules = [ "solver" ];
+Solver.solver.type = "Nonlin";
+Solver.solver.tiny = 1e-6;
+
+// SETTINGS
+params.rod_details.material.type = "ElasticRod";
+params.rod_details.material.young = 1e8;
+params.rod_details.material.poisson_ratio = .0;
+params.rod_details.material.area = 4e-2;
+params.rod_details.material.area_moment = 2e-4;
+params.rod_details.material.shear_correction = 1.;
+
+params.force_model.type = "Dirichlet";
+
+params.force_model.dispIncr = 0.3;
+params.force_model.nodeGroups = [ "moving_left", "moving_left", "moving_left", "moving_left", "moving_left", "moving_left" ];
+params.force_model.dofs = ["dx", "dy", "dz", "rx", "ry", "rz" ];
+params.force_model.factors = [ 0., 0., -1., 0., 0., 0.]; 
+
+// include model and i/o files
+include "input.pro";
+include "model.pro";
+include "output.pro";
+
+Input.groupInput.nodeGroups += [ "moving_left" ];
+Input.groupInput.moving_left.xtype = "min";
+
+model.model.model.lattice.contact.penaltySTS = 1e4;
+model.model.model.lattice.contact.penaltyNTS = 1e4;
+model.model.model.lattice.contact.radius = 0.2;
+model.model.model.lattice.contact.selfContact = true;
+model.model.model.lattice.contact.verbose = true;
+
+Output.modules += [ "energy" ];
+
+Output.loadextent.nodeGroups = ["moving_left"];
+Output.disp.dataSets = [ "moving_left.disp.dx", "moving_left.disp.dy", "moving_left.disp.dz", "moving_left.disp.rx", "moving_left.disp.ry", "moving_left.disp.rz" ];
+Output.resp.dataSets = [ "moving_left.resp.dx", "moving_left.resp.dy", "moving_left.resp.dz", "moving_left.resp.rx", "moving_left.resp.ry", "moving_left.resp.rz" ];
+
+Output.energy.type = "Sample";
+Output.energy.file = "$(CASE_NAME)/energy.csv";
+Output.energy.dataSets = [ "i", "contactEnergy" ];
+Output.energy.separator = ",";
+
+Output.paraview.sampleWhen = true;
+Output.paraview.beams.shape = "Line2";
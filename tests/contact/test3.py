@@ -0,0 +1,51 @@
+#!/usr/bin/python3
+
+# single rod pushed onto itself where it loops over its first branch
+
+import sys
+import os
+import numpy as np
+from termcolor import colored
+from matplotlib import pyplot as plt
+
+RADIUS = 0.2
+PENALTY = 1e4
+GAP = 1. - 2 * RADIUS
+
+test_passed = False
+
+try:
+  sim_disp = np.loadtxt("tests/contact/test3/disp.csv", delimiter=',')
+  sim_resp = np.loadtxt("tests/contact/test3/resp.csv", delimiter=',')
+  sim_energy = np.loadtxt("tests/contact/test3/energy.csv", delimiter=',')
+
+  # bound of the deepest penetration from the penalty energy of all pairs
+  penetration = np.sqrt(2 * sim_energy[:, 1] / PENALTY)
+
+  plt.figure(figsize=(16/3, 6))
+
+  plt.plot(-sim_disp[:, 2], np.sqrt(sim_resp[:, 0]**2 + sim_resp[:, 1]
+           ** 2 + sim_resp[:, 2]**2), label="custom implementation")
+  plt.axvline(GAP, label="initial gap", color="gray", linestyle="--")
+
+  plt.xlabel("prescribed displacement (m)")
+  plt.ylabel("support force (N)")
+
+  plt.legend()
+
+  # the branches have to touch once the gap is closed, but never pass through
+  touched = sim_energy[-sim_disp[:, 2] > 1.5 * GAP, 1] > 0.
+  test_passed = np.all(touched) and np.max(penetration) < RADIUS
+
+except Exception as e:
+  print(e)
+
+if test_passed:
+  print(colored("CONTACT TEST 3 PASSED", "green"))
+
+  plt.tight_layout()
+  plt.savefig("tests/contact/test3/result.pdf")
+  plt.savefig("tests/contact3_result.png")
+else:
+  print(colored("CONTACT TEST 3 FAILED", "red", attrs=["bold"]))
+  sys.exit(1)
@@ -0,0 +1,54 @@
+#!/usr/bin/python3
+
+# TEST 4 (Test 1 evaluated on 4 threads)
+import sys
+import numpy as np
+from pathlib import Path
+from termcolor import colored
+from matplotlib import pyplot as plt
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+from metrics import relative_L2
+
+TOL = 1e-10
+
+test_passed = False
+
+try:
+  sim_disp = np.loadtxt("tests/contact/test4/disp.csv", delimiter=',')
+  sim_resp = np.loadtxt("tests/contact/test4/resp.csv", delimiter=',')
+  ref_disp = np.loadtxt("tests/contact/test1/disp.csv", delimiter=',')
+  ref_resp = np.loadtxt("tests/contact/test1/resp.csv", delimiter=',')
+
+  plt.figure(figsize=(16/3, 6))
+
+  plt.plot(np.sqrt(sim_resp[:, 0]**2 + sim_resp[:, 1]
+           ** 2 + sim_resp[:, 2]**2), label="4 threads")
+  plt.plot(np.sqrt(ref_resp[:, 0]**2 + ref_resp[:, 1]
+           ** 2 + ref_resp[:, 2]**2), label="1 thread (Test 1)", linestyle="--")
+
+  plt.xlabel("iteration")
+  plt.ylabel("contact force (N)")
+
+  plt.legend()
+
+  # the contributions are assembled in element and pair order, so the
+  # thread count must not change the results
+  err_disp = relative_L2(sim_disp, ref_disp)
+  err_resp = relative_L2(sim_resp, ref_resp)
+  print(f"relative difference to the serial run: {err_disp}, {err_resp}")
+  test_passed = sim_resp.shape == ref_resp.shape and \
+      err_disp <= TOL and err_resp <= TOL
+
+except Exception as e:
+  print(e)
+
+if test_passed:
+  print(colored("CONTACT TEST 4 PASSED", "green"))
+
+  plt.tight_layout()
+  plt.savefig("tests/contact/test4/result.pdf")
+  plt.savefig("tests/contact4_result.png")
+else:
+  print(colored("CONTACT TEST 4 FAILED", "red", attrs=["bold"]))
+  sys.exit(1)
@@ -5,10 +5,10 @@ tests: beam-tests transient-tests plastic-tests contact-tests
 clean-all: clean-tests
 
 # SETTINGS
-beam_cases = 1 2 4 5
-transient_cases = 1 2 3
+beam_cases = 1 2 4 5 6
+transient_cases = 1 2 3 4 5
 plastic_cases = 1 2a 2b 3
-contact_cases = 1
+contact_cases = 1 2 3 4
 
 # general dependency of .pro files on .geo files
 %.pro: %.geo
@@ -25,6 +25,14 @@ tests/beam/test0/result.pdf: tests/beam/test0.py\
 															 tests/beam/test0_ref/resp.csv
 	@$<
 
+# the matrix-free results are compared with the assembled ones of test 5
+tests/beam/test6/result.pdf: tests/beam/test6.py\
+															 tests/beam/test6/disp.csv\
+															 tests/beam/test6/resp.csv\
+															 tests/beam/test5/disp.csv\
+															 tests/beam/test5/resp.csv
+	@$<
+
 tests/beam/test%/result.pdf: tests/beam/test%.py\
 															 tests/beam/test%/disp.csv\
 															 tests/beam/test%/resp.csv
@@ -74,6 +82,14 @@ tests/plastic/test%.pro: tests/plastic/input.pro tests/plastic/output.pro tests/
 
 contact-tests: $(addprefix tests/contact/test, $(addsuffix /result.pdf, $(contact_cases)))
 
+# the threaded results are compared with the serial ones of test 1
+tests/contact/test4/result.pdf: tests/contact/test4.py\
+															 tests/contact/test4/disp.csv\
+															 tests/contact/test4/resp.csv\
+															 tests/contact/test1/disp.csv\
+															 tests/contact/test1/resp.csv
+	@$<
+
 tests/contact/test%/result.pdf: tests/contact/test%.py\
 															 tests/contact/test%/disp.csv\
 															 tests/contact/test%/resp.csv
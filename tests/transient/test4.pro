@@ -0,0 +1,47 @@
+// Lang et al 2011 "Multibody Dynamics Simulation of geometrically exact Cossrat rods Example 1
+// leap-frog integration with batched steps
+
+// PROGRAM_CONTROL
+control.runWhile = "t <= 1";
+
+// SOLVER
+Solver.modules = [ "integrator" ];
+Solver.integrator.type = "LeapFrog";
+Solver.integrator.deltaTime = 1e-5;
+Solver.integrator.dofs_SO3 = [ "rx", "ry", "rz" ];
+Solver.integrator.updateWhen = "t < 0";
+Solver.integrator.batchSteps = 50;
+Solver.integrator.batchBreak = "t % 1e-4 < deltaTime";
+
+// settings
+params.rod_details.material.type = "ElasticRod";
+params.rod_details.material.cross_section = "circle";
+params.rod_details.material.radius = 5e-3;
+params.rod_details.material.young = 5e6;
+params.rod_details.material.poisson_ratio = 0.4999999;
+params.rod_details.material.shear_correction = 1.;
+params.rod_details.material.density = 1.1e3;
+
+
+// include model and i/o files
+include "input.pro";
+include "model.pro";
+include "output.pro";
+
+// more settings
+Input.input.onelab.size = 0.1;
+
+model.model.force.type = "Neumann";
+model.model.force.loadIncr = 0.;
+model.model.force.initLoad = "PI * (5e-3)^2 * $(Input.input.onelab.size) * 1.1e3 * 9.81";
+model.model.force.nodeGroups =  [ "all", "free", "fixed" ] ;
+model.model.force.factors = [ -1., 0.5, 0.5 ];
+model.model.force.dofs = [ "dz", "dz", "dz" ];
+
+model.model.fixed.nodeGroups = [ "fixed", "fixed", "fixed" ];
+model.model.fixed.dofs = model.model.rodMesh.child.dofNamesTrans;
+model.model.fixed.factors = [ 0., 0., 0. ]; 
+
+model.model.disp.type = "None";
+
+Output.disp.saveWhen = "t % 1e-4 < deltaTime";
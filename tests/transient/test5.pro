@@ -0,0 +1,49 @@
+// SIMO et al Example 5.2
+// leap-frog integration, the coarse leg runs at twice the step of the fine leg
+
+// PROGRAM_CONTROL
+control.runWhile = "t <= 30";
+
+// SOLVER
+Solver.modules = [ "integrator" ];
+Solver.integrator.type = "LeapFrog";
+Solver.integrator.deltaTime = 1e-5;
+Solver.integrator.dofs_SO3 = [ "rx", "ry", "rz" ];
+Solver.integrator.updateWhen = "i%20 < 1";
+Solver.integrator.subcycleLevels = 1;
+
+// settings
+params.rod_details.material.type = "ElasticRod";
+params.rod_details.material.cross_section = "square";
+params.rod_details.material.side_length = "sqrt(12e-3)";
+params.rod_details.material.young = "1e9/12";
+params.rod_details.material.shear_modulus = "5e8/12";
+params.rod_details.material.shear_correction	= 2.;
+params.rod_details.material.density = "1e3/12";
+params.rod_details.material.inertia_correct = 1e4;
+
+
+// include model and i/o files
+include "input.pro";
+include "model.pro";
+include "output.pro";
+
+// more settings
+Input.input.order = 2;
+
+Input.groupInput.fixed.ytype = "max";
+Input.groupInput.free.ytype = "min";
+Input.groupInput.nodeGroups += "elbow";
+Input.groupInput.elbow.xtype = "max";
+Input.groupInput.elbow.ytype = "max";
+
+model.model.force.type = "LoadScale";
+model.model.force.scaleFunc = "if (t<=2, if (t<=1, t*50, (2-t)*50), 0)";
+model.model.force.model.type = "Neumann";
+model.model.force.model.nodeGroups =  [ "elbow" ] ;
+model.model.force.model.factors = [ 1. ];
+model.model.force.model.dofs = [ "dz" ];
+
+model.model.disp.type = "None";
+
+Output.disp.saveWhen = "t % 0.001 < deltaTime";
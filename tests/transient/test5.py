@@ -0,0 +1,73 @@
+#!/usr/bin/python3
+
+# TEST 5 (Simo Paper 3D-Test, leap-frog with subcycling)
+
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+from pathlib import Path
+from termcolor import colored
+from matplotlib.backends.backend_pdf import PdfPages
+
+sys.path.insert(0, str(Path(__file__).parent.parent))
+from metrics import interp_on_reference, relative_L2
+
+TOL = 0.05
+
+test_passed = False
+
+try:
+  disp = pd.read_csv("tests/transient/test5/disp.gz", index_col="time")
+  ref_disp = pd.read_csv("tests/transient/ref_data/test3_ref.csv",
+                        header=[0, 1])
+
+  ellbow = disp[["dx[1]", "dy[1]", "dz[1]"]]
+  tip = disp[["dx[2]", "dy[2]", "dz[2]"]]
+
+  # Relative L2 comparison of out-of-plane displacements vs Simo & Vu-Quoc 1988
+  t_sim = disp.index.values.astype(float)
+  t_ellbow_ref = ref_disp["Ellbow"]["X"].values
+  y_ellbow_ref = ref_disp["Ellbow"]["Y"].values
+  t_tip_ref = ref_disp["Tip"].dropna()["X"].values
+  y_tip_ref = ref_disp["Tip"].dropna()["Y"].values
+
+  err_ellbow = relative_L2(
+      interp_on_reference(t_sim, ellbow["dz[1]"].values, t_ellbow_ref),
+      y_ellbow_ref)
+  err_tip = relative_L2(
+      interp_on_reference(t_sim, tip["dz[2]"].values, t_tip_ref),
+      y_tip_ref)
+  test_passed = (err_ellbow <= TOL) and (err_tip <= TOL)
+
+  # the coarse leg has to be subcycled
+  with open("tests/transient/test5/run.log") as log:
+    test_passed = test_passed and "Subcycling with 2 substeps" in log.read()
+
+except Exception as e:
+  print(e)
+
+if test_passed and max(disp.index) > 29.9:
+  print(colored("TRANSIENT TEST 5 PASSED", "green"))
+  
+  with PdfPages("tests/transient/test5/result.pdf") as file:
+    plt.plot(ellbow["dz[1]"], label="ellbow (custom implementation)")
+    plt.plot(ref_disp["Ellbow"]["X"],
+            ref_disp["Ellbow"]["Y"],
+            "--",
+            label="ellbow (Simo, Vu-Quoc 1988)")
+    plt.plot(tip["dz[2]"], label="tip (custom implementation)")
+    plt.plot(ref_disp["Tip"]["X"],
+            ref_disp["Tip"]["Y"],
+            "--",
+            label="tip (Simo, Vu-Quoc 1988)")
+    plt.xlim(0, 30)
+    plt.ylim(-10, 10)
+    plt.legend()
+    plt.xlabel("time (s)")
+    plt.ylabel("out-of-plane displacement (m)")
+    plt.tight_layout()
+    file.savefig()
+    plt.savefig("tests/transient5_result.png")
+else:
+  print(colored("TRANSIENT TEST 5 FAILED", "red", attrs=["bold"]))
+  sys.exit(1)